@@ -0,0 +1,292 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <pthreadpool.h>
+#include <pthreadpool.hpp>
+
+
+/*
+ * Runs the same loops through pthreadpool (C functions and C++ lambdas), OpenMP parallel for with static and dynamic schedules (if the benchmark is
+ * built with OpenMP), and a naive fork-join of std::threads which split the items evenly. All runtimes use one thread
+ * per online processor. Latency benchmarks run loops of one empty item per thread; throughput benchmarks run large
+ * loops of light items.
+ */
+
+static size_t GetThreadsCount() {
+	return static_cast<size_t>(sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+const size_t throughputItems = 1000000;
+const size_t rows = 1000;
+const size_t columns = 1000;
+const size_t tileRows = 16;
+const size_t tileColumns = 64;
+
+/* Light work on an item: a short dependent chain of integer operations */
+static inline void Work(size_t x) {
+	uint32_t seed = static_cast<uint32_t>(x);
+	for (uint32_t i = 0; i < 16; i++) {
+		seed = seed * UINT32_C(1664525) + UINT32_C(1013904223);
+	}
+	benchmark::DoNotOptimize(seed);
+}
+
+static void compute_1d(void* context, size_t x) {
+	Work(x);
+}
+
+static void compute_2d(void* context, size_t i, size_t j) {
+	Work(i * columns + j);
+}
+
+static void compute_2d_tiled(void* context, size_t i0, size_t j0, size_t in, size_t jn) {
+	for (size_t i = i0; i < i0 + in; i++) {
+		for (size_t j = j0; j < j0 + jn; j++) {
+			Work(i * columns + j);
+		}
+	}
+}
+
+static void empty_1d(void* context, size_t x) {
+	benchmark::DoNotOptimize(x);
+}
+
+/* Processes items [0, range) with threadsCount newly created threads, which each process a contiguous part */
+template <class Function>
+static void ForkJoin(size_t threadsCount, size_t range, Function function) {
+	std::vector<std::thread> threads;
+	threads.reserve(threadsCount);
+	for (size_t t = 0; t < threadsCount; t++) {
+		const size_t start = range * t / threadsCount;
+		const size_t end = range * (t + 1) / threadsCount;
+		threads.emplace_back([=]() {
+			for (size_t x = start; x < end; x++) {
+				function(x);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+
+static void compute_1d_latency_pthreadpool(benchmark::State& state) {
+	const size_t threads = GetThreadsCount();
+	pthreadpool_t threadpool = pthreadpool_create(threads);
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d(threadpool, empty_1d, NULL, threads);
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(compute_1d_latency_pthreadpool)->UseRealTime();
+
+static void compute_1d_latency_std_thread(benchmark::State& state) {
+	const size_t threads = GetThreadsCount();
+	while (state.KeepRunning()) {
+		ForkJoin(threads, threads, [](size_t x) { empty_1d(NULL, x); });
+	}
+}
+BENCHMARK(compute_1d_latency_std_thread)->UseRealTime();
+
+static void compute_1d_pthreadpool(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(GetThreadsCount());
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, throughputItems);
+	}
+	pthreadpool_destroy(threadpool);
+	state.SetItemsProcessed(int64_t(state.iterations()) * throughputItems);
+}
+BENCHMARK(compute_1d_pthreadpool)->UseRealTime();
+
+static void compute_1d_pthreadpool_lambda(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(GetThreadsCount());
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d(threadpool, [](size_t x) { Work(x); }, throughputItems);
+	}
+	pthreadpool_destroy(threadpool);
+	state.SetItemsProcessed(int64_t(state.iterations()) * throughputItems);
+}
+BENCHMARK(compute_1d_pthreadpool_lambda)->UseRealTime();
+
+static void compute_1d_std_thread(benchmark::State& state) {
+	const size_t threads = GetThreadsCount();
+	while (state.KeepRunning()) {
+		ForkJoin(threads, throughputItems, [](size_t x) { compute_1d(NULL, x); });
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * throughputItems);
+}
+BENCHMARK(compute_1d_std_thread)->UseRealTime();
+
+static void compute_2d_pthreadpool(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(GetThreadsCount());
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d(threadpool, compute_2d, NULL, rows, columns);
+	}
+	pthreadpool_destroy(threadpool);
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_pthreadpool)->UseRealTime();
+
+static void compute_2d_pthreadpool_lambda(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(GetThreadsCount());
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d(threadpool, [](size_t i, size_t j) { Work(i * columns + j); }, rows, columns);
+	}
+	pthreadpool_destroy(threadpool);
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_pthreadpool_lambda)->UseRealTime();
+
+static void compute_2d_std_thread(benchmark::State& state) {
+	const size_t threads = GetThreadsCount();
+	while (state.KeepRunning()) {
+		ForkJoin(threads, rows, [](size_t i) {
+			for (size_t j = 0; j < columns; j++) {
+				compute_2d(NULL, i, j);
+			}
+		});
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_std_thread)->UseRealTime();
+
+static void compute_2d_tiled_pthreadpool(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(GetThreadsCount());
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d_tiled(threadpool, compute_2d_tiled, NULL, rows, columns, tileRows, tileColumns);
+	}
+	pthreadpool_destroy(threadpool);
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_tiled_pthreadpool)->UseRealTime();
+
+static void compute_2d_tiled_std_thread(benchmark::State& state) {
+	const size_t threads = GetThreadsCount();
+	const size_t tilesI = (rows + tileRows - 1) / tileRows;
+	const size_t tilesJ = (columns + tileColumns - 1) / tileColumns;
+	while (state.KeepRunning()) {
+		ForkJoin(threads, tilesI * tilesJ, [=](size_t tile) {
+			const size_t i = tile / tilesJ * tileRows;
+			const size_t j = tile % tilesJ * tileColumns;
+			compute_2d_tiled(NULL, i, j, std::min(tileRows, rows - i), std::min(tileColumns, columns - j));
+		});
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_tiled_std_thread)->UseRealTime();
+
+
+#if PTHREADPOOL_BENCHMARK_OPENMP
+static void compute_1d_latency_omp_static(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for schedule(static) num_threads(threads)
+		for (int x = 0; x < threads; x++) {
+			empty_1d(NULL, static_cast<size_t>(x));
+		}
+	}
+}
+BENCHMARK(compute_1d_latency_omp_static)->UseRealTime();
+
+static void compute_1d_latency_omp_dynamic(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for schedule(dynamic) num_threads(threads)
+		for (int x = 0; x < threads; x++) {
+			empty_1d(NULL, static_cast<size_t>(x));
+		}
+	}
+}
+BENCHMARK(compute_1d_latency_omp_dynamic)->UseRealTime();
+
+static void compute_1d_omp_static(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for schedule(static) num_threads(threads)
+		for (long x = 0; x < long(throughputItems); x++) {
+			compute_1d(NULL, static_cast<size_t>(x));
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * throughputItems);
+}
+BENCHMARK(compute_1d_omp_static)->UseRealTime();
+
+static void compute_1d_omp_dynamic(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for schedule(dynamic) num_threads(threads)
+		for (long x = 0; x < long(throughputItems); x++) {
+			compute_1d(NULL, static_cast<size_t>(x));
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * throughputItems);
+}
+BENCHMARK(compute_1d_omp_dynamic)->UseRealTime();
+
+static void compute_2d_omp_static(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for collapse(2) schedule(static) num_threads(threads)
+		for (long i = 0; i < long(rows); i++) {
+			for (long j = 0; j < long(columns); j++) {
+				compute_2d(NULL, static_cast<size_t>(i), static_cast<size_t>(j));
+			}
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_omp_static)->UseRealTime();
+
+static void compute_2d_omp_dynamic(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(threads)
+		for (long i = 0; i < long(rows); i++) {
+			for (long j = 0; j < long(columns); j++) {
+				compute_2d(NULL, static_cast<size_t>(i), static_cast<size_t>(j));
+			}
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_omp_dynamic)->UseRealTime();
+
+static void compute_2d_tiled_omp_static(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for collapse(2) schedule(static) num_threads(threads)
+		for (long i = 0; i < long(rows); i += long(tileRows)) {
+			for (long j = 0; j < long(columns); j += long(tileColumns)) {
+				compute_2d_tiled(NULL, static_cast<size_t>(i), static_cast<size_t>(j),
+					std::min(tileRows, rows - size_t(i)), std::min(tileColumns, columns - size_t(j)));
+			}
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_tiled_omp_static)->UseRealTime();
+
+static void compute_2d_tiled_omp_dynamic(benchmark::State& state) {
+	const int threads = static_cast<int>(GetThreadsCount());
+	while (state.KeepRunning()) {
+		#pragma omp parallel for collapse(2) schedule(dynamic) num_threads(threads)
+		for (long i = 0; i < long(rows); i += long(tileRows)) {
+			for (long j = 0; j < long(columns); j += long(tileColumns)) {
+				compute_2d_tiled(NULL, static_cast<size_t>(i), static_cast<size_t>(j),
+					std::min(tileRows, rows - size_t(i)), std::min(tileColumns, columns - size_t(j)));
+			}
+		}
+	}
+	state.SetItemsProcessed(int64_t(state.iterations()) * rows * columns);
+}
+BENCHMARK(compute_2d_tiled_omp_dynamic)->UseRealTime();
+#endif
+
+
+BENCHMARK_MAIN();
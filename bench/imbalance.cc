@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <pthreadpool.h>
+
+
+/* The number of items in a loop, and the average number of work iterations per item */
+const size_t items = 10000;
+const uint32_t averageCost = 2000;
+
+enum class Skew {
+	/* The cost of items grows linearly from the first item to the last */
+	Linear,
+	/* The cost of items grows exponentially, so that the last few percent of items dominate the loop */
+	Exponential,
+	/* The costs of items are exponentially distributed and randomly ordered */
+	Random,
+};
+
+/* Returns the costs of items with the specified skew, scaled to average to averageCost */
+static std::vector<uint32_t> GetItemCosts(Skew skew) {
+	std::vector<double> weights(items);
+	std::mt19937 generator(42);
+	std::exponential_distribution<double> distribution;
+	for (size_t i = 0; i < items; i++) {
+		const double position = double(i) / double(items);
+		switch (skew) {
+			case Skew::Linear:
+				weights[i] = position;
+				break;
+			case Skew::Exponential:
+				weights[i] = std::exp2(16.0 * position);
+				break;
+			case Skew::Random:
+				weights[i] = distribution(generator);
+				break;
+		}
+	}
+	double weightsSum = 0.0;
+	for (double weight : weights) {
+		weightsSum += weight;
+	}
+	std::vector<uint32_t> costs(items);
+	for (size_t i = 0; i < items; i++) {
+		costs[i] = static_cast<uint32_t>(std::lround(weights[i] * double(averageCost) * double(items) / weightsSum));
+	}
+	return costs;
+}
+
+/* Runs a dependent chain of the specified number of integer operations, which the compiler cannot shorten */
+static uint32_t Work(uint32_t iterations, uint32_t seed) {
+	for (uint32_t i = 0; i < iterations; i++) {
+		seed = seed * UINT32_C(1664525) + UINT32_C(1013904223);
+	}
+	return seed;
+}
+
+static void compute_1d(void* context, size_t x) {
+	const uint32_t* costs = static_cast<const uint32_t*>(context);
+	benchmark::DoNotOptimize(Work(costs[x], static_cast<uint32_t>(x)));
+}
+
+/*
+ * Measures a loop with skewed per-item costs, processed by the specified function.
+ * The efficiency counter is the sequential time over the parallel time multiplied by the number of threads:
+ * 1 for perfect load balancing on all threads, and lower if threads wait for stragglers or for work to steal.
+ */
+template <class ComputeFunction>
+static void RunSkewed(benchmark::State& state, Skew skew, ComputeFunction compute) {
+	std::vector<uint32_t> costs = GetItemCosts(skew);
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+
+	/* The best of a few sequential runs on the calling thread is the reference for the efficiency */
+	std::chrono::duration<double> sequentialTime = std::chrono::duration<double>::max();
+	for (int run = 0; run < 3; run++) {
+		const auto start = std::chrono::steady_clock::now();
+		pthreadpool_compute_1d(NULL, compute_1d, costs.data(), items);
+		sequentialTime = std::min<std::chrono::duration<double>>(sequentialTime, std::chrono::steady_clock::now() - start);
+	}
+
+	std::chrono::duration<double> parallelTime(0.0);
+	while (state.KeepRunning()) {
+		const auto start = std::chrono::steady_clock::now();
+		compute(threadpool, compute_1d, costs.data(), items);
+		parallelTime += std::chrono::steady_clock::now() - start;
+	}
+	pthreadpool_destroy(threadpool);
+
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+	if (state.iterations() != 0) {
+		state.counters["efficiency"] =
+			sequentialTime.count() * double(state.iterations()) / (parallelTime.count() * double(threads));
+	}
+}
+
+static void pthreadpool_compute_1d_skewed(benchmark::State& state, Skew skew) {
+	RunSkewed(state, skew, pthreadpool_compute_1d);
+}
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed, linear, Skew::Linear)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed, exponential, Skew::Exponential)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed, random, Skew::Random)->UseRealTime();
+
+static void pthreadpool_compute_1d_skewed_static(benchmark::State& state, Skew skew) {
+	RunSkewed(state, skew, [](pthreadpool_t threadpool, pthreadpool_function_1d_t function, void* argument, size_t range) {
+		pthreadpool_compute_1d_with_flags(threadpool, function, argument, range, PTHREADPOOL_FLAG_SCHEDULE_STATIC);
+	});
+}
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_static, linear, Skew::Linear)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_static, exponential, Skew::Exponential)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_static, random, Skew::Random)->UseRealTime();
+
+static void pthreadpool_compute_1d_skewed_guided(benchmark::State& state, Skew skew) {
+	RunSkewed(state, skew, [](pthreadpool_t threadpool, pthreadpool_function_1d_t function, void* argument, size_t range) {
+		pthreadpool_compute_1d_with_flags(threadpool, function, argument, range, PTHREADPOOL_FLAG_SCHEDULE_GUIDED);
+	});
+}
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_guided, linear, Skew::Linear)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_guided, exponential, Skew::Exponential)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_guided, random, Skew::Random)->UseRealTime();
+
+static void pthreadpool_compute_1d_skewed_auto_grain(benchmark::State& state, Skew skew) {
+	RunSkewed(state, skew, [](pthreadpool_t threadpool, pthreadpool_function_1d_t function, void* argument, size_t range) {
+		pthreadpool_compute_1d_with_grain(threadpool, function, argument, range, PTHREADPOOL_GRAIN_AUTO);
+	});
+}
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_auto_grain, linear, Skew::Linear)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_auto_grain, exponential, Skew::Exponential)->UseRealTime();
+BENCHMARK_CAPTURE(pthreadpool_compute_1d_skewed_auto_grain, random, Skew::Random)->UseRealTime();
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <pthreadpool.h>
+
+
+/*
+ * Memory-bound kernel: triad c = a + s * b over rows x columns matrices, which together exceed the last-level cache.
+ * Tiles of state.range(0) x state.range(1) elements show the cost of the tile shape and of the scheduling of tiles.
+ */
+const size_t streamRows = 2048;
+const size_t streamColumns = 2048;
+
+struct StreamContext {
+	const float* a;
+	const float* b;
+	float* c;
+	float s;
+};
+
+static void compute_stream_tile(void* context, size_t i0, size_t j0, size_t in, size_t jn) {
+	const StreamContext* stream = static_cast<const StreamContext*>(context);
+	for (size_t i = i0; i < i0 + in; i++) {
+		const float* a = stream->a + i * streamColumns;
+		const float* b = stream->b + i * streamColumns;
+		float* c = stream->c + i * streamColumns;
+		for (size_t j = j0; j < j0 + jn; j++) {
+			c[j] = a[j] + stream->s * b[j];
+		}
+	}
+}
+
+static void SetStreamTiles(benchmark::internal::Benchmark* benchmark) {
+	benchmark->Args({1, static_cast<int>(streamColumns)});
+	benchmark->Args({4, 512});
+	benchmark->Args({16, 128});
+	benchmark->Args({64, 64});
+	benchmark->Args({256, 16});
+}
+
+static void pthreadpool_compute_2d_tiled_stream(benchmark::State& state) {
+	std::vector<float> a(streamRows * streamColumns, 1.0f);
+	std::vector<float> b(streamRows * streamColumns, 2.0f);
+	std::vector<float> c(streamRows * streamColumns);
+	StreamContext context = { a.data(), b.data(), c.data(), 3.0f };
+	const size_t tileRows = static_cast<size_t>(state.range(0));
+	const size_t tileColumns = static_cast<size_t>(state.range(1));
+
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d_tiled(threadpool, compute_stream_tile, &context,
+			streamRows, streamColumns, tileRows, tileColumns);
+		benchmark::DoNotOptimize(c.data());
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Two matrices are read and one is written */
+	state.SetBytesProcessed(int64_t(state.iterations()) * 3 * streamRows * streamColumns * sizeof(float));
+}
+BENCHMARK(pthreadpool_compute_2d_tiled_stream)->UseRealTime()->Apply(SetStreamTiles);
+
+
+/*
+ * Compute-bound kernel: C = A * B for M x K matrix A and K x N matrix B, where the tiles of C are computed in parallel.
+ * The matrices fit into the last-level cache, and tiles of state.range(0) x state.range(1) elements of C
+ * reuse rows of A and columns of B from the inner levels of the cache. Variants differ in the traversal order of tiles.
+ */
+const size_t gemmM = 512;
+const size_t gemmN = 512;
+const size_t gemmK = 128;
+
+struct GemmContext {
+	const float* a;
+	const float* b;
+	float* c;
+};
+
+static void compute_gemm_tile(void* context, size_t i0, size_t j0, size_t in, size_t jn) {
+	const GemmContext* gemm = static_cast<const GemmContext*>(context);
+	for (size_t i = i0; i < i0 + in; i++) {
+		float* c = gemm->c + i * gemmN;
+		std::fill(c + j0, c + j0 + jn, 0.0f);
+		for (size_t k = 0; k < gemmK; k++) {
+			const float a = gemm->a[i * gemmK + k];
+			const float* b = gemm->b + k * gemmN;
+			for (size_t j = j0; j < j0 + jn; j++) {
+				c[j] += a * b[j];
+			}
+		}
+	}
+}
+
+static void SetGemmTiles(benchmark::internal::Benchmark* benchmark) {
+	benchmark->Args({4, 16});
+	benchmark->Args({8, 64});
+	benchmark->Args({32, 32});
+	benchmark->Args({64, 128});
+}
+
+static void pthreadpool_compute_2d_tiled_gemm(benchmark::State& state, uint32_t flags) {
+	std::vector<float> a(gemmM * gemmK, 1.0f);
+	std::vector<float> b(gemmK * gemmN, 0.5f);
+	std::vector<float> c(gemmM * gemmN);
+	GemmContext context = { a.data(), b.data(), c.data() };
+	const size_t tileM = static_cast<size_t>(state.range(0));
+	const size_t tileN = static_cast<size_t>(state.range(1));
+
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d_tiled_with_flags(threadpool, compute_gemm_tile, &context, gemmM, gemmN, tileM, tileN, flags);
+		benchmark::DoNotOptimize(c.data());
+	}
+	pthreadpool_destroy(threadpool);
+
+	state.counters["FLOPS"] = benchmark::Counter(
+		double(state.iterations()) * 2.0 * double(gemmM) * double(gemmN) * double(gemmK), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(pthreadpool_compute_2d_tiled_gemm, row_major, PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR)
+	->UseRealTime()->Apply(SetGemmTiles);
+BENCHMARK_CAPTURE(pthreadpool_compute_2d_tiled_gemm, column_major, PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR)
+	->UseRealTime()->Apply(SetGemmTiles);
+BENCHMARK_CAPTURE(pthreadpool_compute_2d_tiled_gemm, morton, PTHREADPOOL_FLAG_TRAVERSAL_MORTON)
+	->UseRealTime()->Apply(SetGemmTiles);
+BENCHMARK_CAPTURE(pthreadpool_compute_2d_tiled_gemm, hilbert, PTHREADPOOL_FLAG_TRAVERSAL_HILBERT)
+	->UseRealTime()->Apply(SetGemmTiles);
+
+
+BENCHMARK_MAIN();
@@ -26,6 +26,87 @@ static void pthreadpool_compute_1d(benchmark::State& state) {
 }
 BENCHMARK(pthreadpool_compute_1d)->UseRealTime()->Apply(SetNumberOfThreads);
 
+static void pthreadpool_compute_1d_no_spin(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	/* Always sleep on futex: every call pays for waking up the workers and the caller */
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, threads);
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_compute_1d_no_spin)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_compute_1d_dedicated_workers(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_attributes attributes = { 0 };
+	attributes.threads_count = threads;
+	attributes.flags = PTHREADPOOL_FLAG_DEDICATED_WORKERS;
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create_with_attributes(&attributes);
+	/* The caller thread only waits: compare with pthreadpool_compute_1d, where it processes items as thread 0 */
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, threads);
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_compute_1d_dedicated_workers)->UseRealTime()->Apply(SetNumberOfThreads);
+
+/* Creates a thread pool, runs a loop of a single item, and destroys the thread pool */
+static void RunCreateDestroy(benchmark::State& state, uint32_t flags) {
+	const size_t threads = static_cast<size_t>(state.range(0));
+	pthreadpool_attributes attributes = { 0 };
+	attributes.threads_count = threads;
+	attributes.flags = flags;
+	while (state.KeepRunning()) {
+		pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create_with_attributes(&attributes);
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, 1);
+		pthreadpool_destroy(threadpool);
+	}
+}
+
+static void pthreadpool_create_destroy(benchmark::State& state) {
+	RunCreateDestroy(state, 0);
+}
+BENCHMARK(pthreadpool_create_destroy)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_create_destroy_lazy_workers(benchmark::State& state) {
+	/* The loop of a single item runs on the calling thread, and no worker thread starts */
+	RunCreateDestroy(state, PTHREADPOOL_FLAG_LAZY_WORKERS);
+}
+BENCHMARK(pthreadpool_create_destroy_lazy_workers)->UseRealTime()->Apply(SetNumberOfThreads);
+
+/*
+ * Runs a loop of 2 items after an idle period, in which worker threads hibernate if hibernation is enabled.
+ * The number of iterations is fixed, since the idle periods are not measured.
+ */
+static void RunAfterIdle(benchmark::State& state, bool hibernation) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	if (hibernation) {
+		/* One warm worker thread, and all other worker threads hibernate after 1 ms */
+		pthreadpool_set_idle_policy(threadpool, 1, UINT64_C(1000000));
+	}
+	while (state.KeepRunning()) {
+		state.PauseTiming();
+		usleep(5000);
+		state.ResumeTiming();
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, 2);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void pthreadpool_compute_1d_after_idle(benchmark::State& state) {
+	RunAfterIdle(state, false);
+}
+BENCHMARK(pthreadpool_compute_1d_after_idle)->UseRealTime()->Iterations(100)->Apply(SetNumberOfThreads);
+
+static void pthreadpool_compute_1d_after_idle_hibernation(benchmark::State& state) {
+	RunAfterIdle(state, true);
+}
+BENCHMARK(pthreadpool_compute_1d_after_idle_hibernation)->UseRealTime()->Iterations(100)->Apply(SetNumberOfThreads);
+
 
 static void compute_1d_tiled(void* context, size_t x0, size_t xn) {
 }
@@ -69,4 +150,85 @@ static void pthreadpool_compute_2d_tiled(benchmark::State& state) {
 BENCHMARK(pthreadpool_compute_2d_tiled)->UseRealTime()->Apply(SetNumberOfThreads);
 
 
+static void pthreadpool_plan_2d_tiled(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	pthreadpool_plan_t plan = pthreadpool_plan_create_2d_tiled(threadpool, compute_2d_tiled, 1, threads, 1, 1);
+	while (state.KeepRunning()) {
+		pthreadpool_plan_execute(plan, NULL);
+	}
+	pthreadpool_plan_destroy(plan);
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_plan_2d_tiled)->UseRealTime()->Apply(SetNumberOfThreads);
+
+
+/* The number of independent loops dispatched one after another, or as a batch */
+const size_t batchSize = 5;
+
+static void pthreadpool_compute_1d_sequence(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	while (state.KeepRunning()) {
+		for (size_t i = 0; i < batchSize; i++) {
+			pthreadpool_compute_1d(threadpool, compute_1d, NULL, threads);
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_compute_1d_sequence)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_compute_batch(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	pthreadpool_loop loops[batchSize];
+	for (pthreadpool_loop& loop : loops) {
+		loop = pthreadpool_loop();
+		loop.type = pthreadpool_loop_1d;
+		loop.function.function_1d = compute_1d;
+		loop.range_i = threads;
+	}
+	while (state.KeepRunning()) {
+		pthreadpool_compute_batch(threadpool, loops, batchSize);
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_compute_batch)->UseRealTime()->Apply(SetNumberOfThreads);
+
+
+/* The number of dependent loops in a chain, such as the layers of a small model */
+const size_t chainLength = 8;
+
+static void pthreadpool_compute_1d_chain(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	while (state.KeepRunning()) {
+		for (size_t i = 0; i < chainLength; i++) {
+			pthreadpool_compute_1d(threadpool, compute_1d, NULL, threads);
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_compute_1d_chain)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_graph_chain(benchmark::State& state) {
+	const uint32_t threads = static_cast<uint32_t>(state.range(0));
+	pthreadpool_t threadpool = threads == 0 ? NULL : pthreadpool_create(threads);
+	pthreadpool_graph_t graph = pthreadpool_graph_create();
+	for (size_t i = 0; i < chainLength; i++) {
+		size_t node;
+		pthreadpool_graph_add_1d(graph, compute_1d, NULL, threads, &node);
+		if (i != 0) {
+			pthreadpool_graph_add_dependency(graph, node, node - 1);
+		}
+	}
+	while (state.KeepRunning()) {
+		pthreadpool_graph_run(threadpool, graph);
+	}
+	pthreadpool_graph_destroy(graph);
+	pthreadpool_destroy(threadpool);
+}
+BENCHMARK(pthreadpool_graph_chain)->UseRealTime()->Apply(SetNumberOfThreads);
+
+
 BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <pthreadpool.h>
+
+
+static void SetNumberOfSubmitters(benchmark::internal::Benchmark* benchmark) {
+	const int maxThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	for (int submitters = 1; submitters <= 2 * maxThreads; submitters *= 2) {
+		benchmark->Arg(submitters);
+	}
+}
+
+/* Items of the small loops whose latency is measured, and of the large loops which compete with them */
+const size_t smallItems = 1000;
+const size_t largeItems = 1000000;
+
+static void compute_1d(void* context, size_t x) {
+	benchmark::DoNotOptimize(x);
+}
+
+/* Reports the median and the 99th percentile of the latencies, in microseconds */
+static void ReportLatencyPercentiles(benchmark::State& state, std::vector<double>& latencies) {
+	if (latencies.empty()) {
+		return;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	state.counters["p50_us"] = latencies[latencies.size() / 2];
+	state.counters["p99_us"] = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+}
+
+/*
+ * Measures the latency of small loops submitted by the benchmark thread, while (state.range(0) - 1) other threads
+ * concurrently submit loops of the specified size to the same thread pool.
+ */
+static void RunWithConcurrentSubmitters(benchmark::State& state, size_t otherItems) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t otherSubmitters = static_cast<size_t>(state.range(0)) - 1;
+
+	std::atomic<bool> stop(false);
+	std::vector<std::thread> submitters;
+	for (size_t i = 0; i < otherSubmitters; i++) {
+		submitters.emplace_back([&]() {
+			while (!stop.load(std::memory_order_relaxed)) {
+				pthreadpool_compute_1d(threadpool, compute_1d, NULL, otherItems);
+			}
+		});
+	}
+
+	std::vector<double> latencies;
+	while (state.KeepRunning()) {
+		const auto start = std::chrono::steady_clock::now();
+		pthreadpool_compute_1d(threadpool, compute_1d, NULL, smallItems);
+		const auto end = std::chrono::steady_clock::now();
+		latencies.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+	}
+
+	stop.store(true, std::memory_order_relaxed);
+	for (std::thread& submitter : submitters) {
+		submitter.join();
+	}
+	pthreadpool_destroy(threadpool);
+
+	ReportLatencyPercentiles(state, latencies);
+}
+
+static void pthreadpool_compute_1d_small_with_small(benchmark::State& state) {
+	RunWithConcurrentSubmitters(state, smallItems);
+}
+BENCHMARK(pthreadpool_compute_1d_small_with_small)->UseRealTime()->Apply(SetNumberOfSubmitters);
+
+static void pthreadpool_compute_1d_small_with_large(benchmark::State& state) {
+	RunWithConcurrentSubmitters(state, largeItems);
+}
+BENCHMARK(pthreadpool_compute_1d_small_with_large)->UseRealTime()->Apply(SetNumberOfSubmitters);
+
+
+BENCHMARK_MAIN();
@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <unistd.h>
+
+#include <pthreadpool.h>
+
+
+static void SetNumberOfThreads(benchmark::internal::Benchmark* benchmark) {
+	const int maxThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	for (int t = 1; t <= maxThreads; t++) {
+		benchmark->Arg(t);
+	}
+}
+
+/*
+ * Kernels are loops of a number of items, with the same cost per item.
+ * Strong scaling runs a fixed number of items on state.range(0) threads, and weak scaling a fixed number per thread.
+ */
+const size_t computeItems = 100000;
+const size_t streamRows = 2048;
+const size_t streamColumns = 4096;
+
+/* Compute-bound kernel: a dependent chain of integer operations per item */
+static void compute_work(void* context, size_t x) {
+	uint32_t seed = static_cast<uint32_t>(x);
+	for (uint32_t i = 0; i < 256; i++) {
+		seed = seed * UINT32_C(1664525) + UINT32_C(1013904223);
+	}
+	benchmark::DoNotOptimize(seed);
+}
+
+struct StreamContext {
+	const float* a;
+	const float* b;
+	float* c;
+};
+
+/* Memory-bound kernel: triad c = a + 3 * b over a row of the matrices */
+static void compute_stream_row(void* context, size_t row) {
+	const StreamContext* stream = static_cast<const StreamContext*>(context);
+	const float* a = stream->a + row * streamColumns;
+	const float* b = stream->b + row * streamColumns;
+	float* c = stream->c + row * streamColumns;
+	for (size_t j = 0; j < streamColumns; j++) {
+		c[j] = a[j] + 3.0f * b[j];
+	}
+}
+
+/*
+ * Measures the loop of the specified number of items on state.range(0) threads. The efficiency counter is the time
+ * of the reference items on the calling thread, over the time of the loop multiplied by the number of threads
+ * and by the ratio of reference items to the items of the loop. For weak scaling, the reference items are the
+ * items per thread; for strong scaling, all the items. Efficiency is 1 for perfect linear scaling.
+ */
+static void RunScaling(
+	benchmark::State& state,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t items,
+	size_t referenceItems)
+{
+	const size_t threads = static_cast<size_t>(state.range(0));
+
+	/* The best of a few sequential runs on the calling thread is the reference for the efficiency */
+	std::chrono::duration<double> referenceTime = std::chrono::duration<double>::max();
+	for (int run = 0; run < 3; run++) {
+		const auto start = std::chrono::steady_clock::now();
+		pthreadpool_compute_1d(NULL, function, argument, referenceItems);
+		referenceTime = std::min<std::chrono::duration<double>>(referenceTime, std::chrono::steady_clock::now() - start);
+	}
+
+	pthreadpool_t threadpool = pthreadpool_create(threads);
+	std::chrono::duration<double> parallelTime(0.0);
+	while (state.KeepRunning()) {
+		const auto start = std::chrono::steady_clock::now();
+		pthreadpool_compute_1d(threadpool, function, argument, items);
+		parallelTime += std::chrono::steady_clock::now() - start;
+	}
+	pthreadpool_destroy(threadpool);
+
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+	if (state.iterations() != 0) {
+		const double speedup = referenceTime.count() * double(state.iterations()) * double(items) /
+			(parallelTime.count() * double(referenceItems));
+		state.counters["efficiency"] = speedup / double(threads);
+	}
+}
+
+static void pthreadpool_compute_strong_scaling(benchmark::State& state) {
+	RunScaling(state, compute_work, NULL, computeItems, computeItems);
+}
+BENCHMARK(pthreadpool_compute_strong_scaling)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_compute_weak_scaling(benchmark::State& state) {
+	const size_t threads = static_cast<size_t>(state.range(0));
+	RunScaling(state, compute_work, NULL, computeItems * threads, computeItems);
+}
+BENCHMARK(pthreadpool_compute_weak_scaling)->UseRealTime()->Apply(SetNumberOfThreads);
+
+/* Runs the stream kernel over rows rows and reports the memory bandwidth */
+static void RunStreamScaling(benchmark::State& state, size_t rows, size_t referenceRows) {
+	std::vector<float> a(rows * streamColumns, 1.0f);
+	std::vector<float> b(rows * streamColumns, 2.0f);
+	std::vector<float> c(rows * streamColumns);
+	StreamContext context = { a.data(), b.data(), c.data() };
+	RunScaling(state, compute_stream_row, &context, rows, referenceRows);
+
+	/* Two matrices are read and one is written */
+	state.SetBytesProcessed(int64_t(state.iterations()) * 3 * rows * streamColumns * sizeof(float));
+}
+
+static void pthreadpool_stream_strong_scaling(benchmark::State& state) {
+	RunStreamScaling(state, streamRows, streamRows);
+}
+BENCHMARK(pthreadpool_stream_strong_scaling)->UseRealTime()->Apply(SetNumberOfThreads);
+
+static void pthreadpool_stream_weak_scaling(benchmark::State& state) {
+	const size_t threads = static_cast<size_t>(state.range(0));
+	/* Per-thread rows still exceed the last-level cache, and the total grows with the number of threads */
+	const size_t rowsPerThread = streamRows / 4;
+	RunStreamScaling(state, rowsPerThread * threads, rowsPerThread);
+}
+BENCHMARK(pthreadpool_stream_weak_scaling)->UseRealTime()->Apply(SetNumberOfThreads);
+
+
+BENCHMARK_MAIN();
@@ -22,6 +22,48 @@ static void pthreadpool_compute_1d(benchmark::State& state) {
 }
 BENCHMARK(pthreadpool_compute_1d)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
 
+static void pthreadpool_compute_1d_auto_grain(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+	const size_t items = static_cast<size_t>(state.range(0));
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d_with_grain(threadpool, compute_1d, NULL, items * threads, PTHREADPOOL_GRAIN_AUTO);
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Do not normalize by thread */
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+}
+BENCHMARK(pthreadpool_compute_1d_auto_grain)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
+
+static void pthreadpool_compute_1d_static(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+	const size_t items = static_cast<size_t>(state.range(0));
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d_with_flags(threadpool, compute_1d, NULL, items * threads, PTHREADPOOL_FLAG_SCHEDULE_STATIC);
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Do not normalize by thread */
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+}
+BENCHMARK(pthreadpool_compute_1d_static)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
+
+static void pthreadpool_compute_1d_guided(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+	const size_t items = static_cast<size_t>(state.range(0));
+	while (state.KeepRunning()) {
+		pthreadpool_compute_1d_with_flags(threadpool, compute_1d, NULL, items * threads, PTHREADPOOL_FLAG_SCHEDULE_GUIDED);
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Do not normalize by thread */
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+}
+BENCHMARK(pthreadpool_compute_1d_guided)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
+
 
 static void compute_1d_tiled(void* context, size_t x0, size_t xn) {
 }
@@ -58,6 +100,20 @@ static void pthreadpool_compute_2d(benchmark::State& state) {
 }
 BENCHMARK(pthreadpool_compute_2d)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
 
+static void pthreadpool_compute_2d_auto_grain(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+	const size_t items = static_cast<size_t>(state.range(0));
+	while (state.KeepRunning()) {
+		pthreadpool_compute_2d_with_grain(threadpool, compute_2d, NULL, threads, items, PTHREADPOOL_GRAIN_AUTO);
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Do not normalize by thread */
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+}
+BENCHMARK(pthreadpool_compute_2d_auto_grain)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
+
 
 static void compute_2d_tiled(void* context, size_t x0, size_t y0, size_t xn, size_t yn) {
 }
@@ -77,4 +133,29 @@ static void pthreadpool_compute_2d_tiled(benchmark::State& state) {
 BENCHMARK(pthreadpool_compute_2d_tiled)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
 
 
+static void reduce_1d(void* context, void* accumulator, size_t x) {
+	*static_cast<size_t*>(accumulator) += x;
+}
+
+static void combine_sums(void* context, void* accumulator, const void* other) {
+	*static_cast<size_t*>(accumulator) += *static_cast<const size_t*>(other);
+}
+
+static void pthreadpool_reduce_1d(benchmark::State& state) {
+	pthreadpool_t threadpool = pthreadpool_create(0);
+	const size_t threads = pthreadpool_get_threads_count(threadpool);
+	const size_t items = static_cast<size_t>(state.range(0));
+	while (state.KeepRunning()) {
+		size_t sum = 0;
+		pthreadpool_reduce_1d(threadpool, reduce_1d, combine_sums, NULL, &sum, sizeof(sum), items * threads);
+		benchmark::DoNotOptimize(sum);
+	}
+	pthreadpool_destroy(threadpool);
+
+	/* Do not normalize by thread */
+	state.SetItemsProcessed(int64_t(state.iterations()) * items);
+}
+BENCHMARK(pthreadpool_reduce_1d)->UseRealTime()->RangeMultiplier(10)->Range(10, 1000000);
+
+
 BENCHMARK_MAIN();
@@ -9,14 +9,14 @@ def main(args):
     options = parser.parse_args(args)
     build = confu.Build.from_options(options)
 
-    build.export_cpath("include", ["pthreadpool.h"])
+    build.export_cpath("include", ["pthreadpool.h", "pthreadpool.hpp"])
 
     with build.options(source_dir="src", extra_include_dirs="src", deps=build.deps.fxdiv):
         if build.target.is_emscripten:
-            source = "threadpool-shim.c"
+            sources = ["threadpool-shim.c"]
         else:
-            source = "threadpool-pthreads.c"
-        build.static_library("pthreadpool", build.cc(source))
+            sources = ["portable-api.c", "threadpool-pthreads.c"]
+        build.static_library("pthreadpool", [build.cc(source) for source in sources])
 
     with build.options(source_dir="test", deps=[build, build.deps.googletest]):
         build.unittest("pthreadpool-test", build.cxx("pthreadpool.cc"))
@@ -24,6 +24,10 @@ def main(args):
     with build.options(source_dir="bench", deps=[build, build.deps.googlebenchmark]):
         build.benchmark("latency-bench", build.cxx("latency.cc"))
         build.benchmark("throughput-bench", build.cxx("throughput.cc"))
+        build.benchmark("multitenant-bench", build.cxx("multitenant.cc"))
+        build.benchmark("imbalance-bench", build.cxx("imbalance.cc"))
+        build.benchmark("kernels-bench", build.cxx("kernels.cc"))
+        build.benchmark("scaling-bench", build.cxx("scaling.cc"))
 
     return build
 
@@ -1,15 +1,41 @@
 #include <stddef.h>
+#include <stdint.h>
 
 #ifndef PTHREADPOOL_H
 #define PTHREADPOOL_H
 
 typedef struct pthreadpool* pthreadpool_t;
 
+/**
+ * Handle for waiting on completion of a function submitted to a thread pool.
+ */
+typedef uint32_t pthreadpool_completion_t;
+
+/**
+ * Graph of parallel loops with dependencies between them, see @a pthreadpool_graph_create.
+ */
+typedef struct pthreadpool_graph* pthreadpool_graph_t;
+
+/**
+ * Parallel loop with precomputed parameters, see @a pthreadpool_plan_create_1d.
+ */
+typedef struct pthreadpool_plan* pthreadpool_plan_t;
+
 typedef void (*pthreadpool_function_1d_t)(void*, size_t);
 typedef void (*pthreadpool_function_1d_tiled_t)(void*, size_t, size_t);
 typedef void (*pthreadpool_function_2d_t)(void*, size_t, size_t);
 typedef void (*pthreadpool_function_2d_tiled_t)(void*, size_t, size_t, size_t, size_t);
 typedef void (*pthreadpool_function_3d_t)(void*, size_t, size_t, size_t);
+typedef void (*pthreadpool_function_3d_tiled_t)(void*, size_t, size_t, size_t, size_t, size_t, size_t);
+typedef void (*pthreadpool_function_2d_tiled_with_scratch_t)(void*, size_t, void*, size_t, size_t, size_t, size_t);
+typedef void (*pthreadpool_function_reduce_1d_t)(void*, void*, size_t);
+typedef void (*pthreadpool_function_reduce_1d_tiled_t)(void*, void*, size_t, size_t);
+typedef void (*pthreadpool_function_combine_t)(void*, void*, const void*);
+typedef void (*pthreadpool_function_4d_tiled_t)(void*, size_t, size_t, size_t, size_t, size_t, size_t);
+typedef void (*pthreadpool_function_5d_tiled_t)(void*, size_t, size_t, size_t, size_t, size_t, size_t, size_t);
+typedef void (*pthreadpool_function_6d_tiled_t)(void*, size_t, size_t, size_t, size_t, size_t, size_t, size_t, size_t);
+typedef int (*pthreadpool_function_1d_cancellable_t)(void*, size_t);
+typedef int (*pthreadpool_function_1d_tiled_cancellable_t)(void*, size_t, size_t);
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,27 +50,267 @@ extern "C" {
  *
  * @returns  A pointer to an opaque thread pool object.
  *    On error the function returns NULL and sets errno accordingly.
+ *    Calls from item processing functions fail with EPERM.
  */
 pthreadpool_t pthreadpool_create(size_t threads_count);
 
+/**
+ * Policy of binding worker threads of a thread pool to processors.
+ */
+enum pthreadpool_affinity {
+	/** Do not bind worker threads; the operating system may migrate them between processors. */
+	pthreadpool_affinity_none = 0,
+	/** Bind each worker thread to a processor from the pthreadpool_attributes::cpus list. */
+	pthreadpool_affinity_cpus,
+	/**
+	 * Bind each worker thread to a separate physical core available to the process,
+	 * skipping SMT (hyper-threading) siblings of the cores already used.
+	 */
+	pthreadpool_affinity_physical_cores,
+};
+
+/**
+ * Make all threads of the thread pool worker threads.
+ *
+ * By default, the thread which calls a pthreadpool_compute_* function processes
+ * items as thread 0 together with the worker threads, and a pool of N threads
+ * starts only N-1 worker threads. With this flag the pool starts N worker threads,
+ * and callers only wait for completion, which keeps their threads free.
+ */
+#define PTHREADPOOL_FLAG_DEDICATED_WORKERS 0x00000001
+
+/**
+ * Start worker threads when jobs need them rather than when the pool is created.
+ *
+ * Creating the pool then starts no threads. Each job starts the worker threads
+ * it can keep busy which are not running yet, so jobs of few items start few
+ * threads and a pool which only runs small jobs never starts them all. If a
+ * worker thread fails to start, the job is processed by the threads which run.
+ */
+#define PTHREADPOOL_FLAG_LAZY_WORKERS 0x00000002
+
+/**
+ * Parameters of a thread pool created with @a pthreadpool_create_with_attributes.
+ *
+ * Zero-initialize the structure before setting the fields of interest:
+ * a zero value of a field selects the default behaviour.
+ */
+struct pthreadpool_attributes {
+	/**
+	 * The number of threads in the thread pool.
+	 * A value of 0 creates a thread for each processor selected by the @a affinity policy,
+	 * or for each processor core available in the system if threads are not bound.
+	 */
+	size_t threads_count;
+	/**
+	 * The policy of binding the worker threads to processors.
+	 * If there are more threads than selected processors, the processors are reused round-robin.
+	 */
+	enum pthreadpool_affinity affinity;
+	/**
+	 * Operating system numbers of processors to bind threads to with the pthreadpool_affinity_cpus policy.
+	 */
+	const uint32_t* cpus;
+	/**
+	 * The number of elements in the @a cpus array.
+	 */
+	size_t cpus_count;
+	/**
+	 * Bitwise combination of PTHREADPOOL_FLAG_* flags.
+	 */
+	uint32_t flags;
+};
+
+/**
+ * Creates a thread pool with the specified parameters.
+ *
+ * Worker threads bound to processors on the same NUMA node get adjacent thread
+ * numbers, and steal work from each other before stealing from threads on other
+ * NUMA nodes. Unless PTHREADPOOL_FLAG_DEDICATED_WORKERS is specified, thread 0
+ * is the calling thread, which is never bound.
+ *
+ * @note Binding is done on a best-effort basis: on platforms which do not support
+ *    it, and for processors which are not available to the process, the worker
+ *    threads are left unbound.
+ *
+ * @param[in]  attributes  The parameters of the thread pool. NULL selects the
+ *    defaults, equivalent to pthreadpool_create(0).
+ *
+ * @returns  A pointer to an opaque thread pool object.
+ *    On error the function returns NULL and sets errno accordingly.
+ *    Calls from item processing functions fail with EPERM.
+ */
+pthreadpool_t pthreadpool_create_with_attributes(const struct pthreadpool_attributes* attributes);
+
+/**
+ * Returns the process-wide default thread pool.
+ *
+ * The first call creates a thread pool with a thread per processor core and
+ * PTHREADPOOL_FLAG_LAZY_WORKERS, and later calls return the same thread pool.
+ * Libraries which share the default thread pool rather than creating their own
+ * don't oversubscribe the processors. Calls are thread-safe.
+ *
+ * The default thread pool lives until the process exits: @a pthreadpool_destroy
+ * ignores it. Calls which change its settings, e.g. @a pthreadpool_set_threads_count,
+ * affect all its users.
+ *
+ * @returns  A pointer to the default thread pool, or NULL if it can't be
+ *    created (e.g. in a call from a worker thread). The pthreadpool_compute_*
+ *    functions accept a NULL thread pool and run sequentially on the calling thread.
+ */
+pthreadpool_t pthreadpool_get_default(void);
+
 /**
  * Queries the number of threads in a thread pool.
  *
  * @param[in]  threadpool  The thread pool to query.
  *
- * @returns  The number of threads in the thread pool.
+ * @returns  The number of threads which process new tasks, as last set by
+ *    @a pthreadpool_set_threads_count, or the number of threads in the
+ *    thread pool.
  */
 size_t pthreadpool_get_threads_count(pthreadpool_t threadpool);
 
+/**
+ * Changes the number of threads which process new tasks in a thread pool.
+ *
+ * Worker threads beyond the new number are not destroyed: they finish the
+ * items they already took, and then stay parked without consuming CPU time
+ * until the number of threads grows again. Tasks which are already running
+ * keep using the threads they started with.
+ *
+ * @param[in]  threadpool     The thread pool to resize.
+ * @param[in]  threads_count  The new number of threads, between 1 and the
+ *    number of threads the thread pool was created with.
+ *
+ * @returns  0 on success, or EINVAL if @a threads_count is out of range.
+ */
+int pthreadpool_set_threads_count(pthreadpool_t threadpool, size_t threads_count);
+
+/**
+ * Configures how long threads of a thread pool spin-wait before going to sleep.
+ *
+ * Idle worker threads spin-wait for a new command, and the calling thread
+ * spin-waits for completion of a command, for the specified number of
+ * iterations before sleeping in the operating system. Spinning cuts the
+ * latency of back-to-back calls at the cost of burning processor time;
+ * on oversubscribed systems it is better disabled.
+ *
+ * @param[in,out]  threadpool  The thread pool to configure.
+ * @param[in]      iterations  The number of spin-wait iterations.
+ *    A value of 0 disables spin-waiting.
+ */
+void pthreadpool_set_spin_wait_iterations(pthreadpool_t threadpool, uint32_t iterations);
+
+/**
+ * Configures which idle worker threads of a thread pool hibernate.
+ *
+ * Idle worker threads spin-wait (see @a pthreadpool_set_spin_wait_iterations)
+ * and then sleep until a new task arrives. A task wakes up only as many
+ * sleeping worker threads as it can keep busy, given its number of items and
+ * the number of threads. Worker threads which sleep without a new task for
+ * longer than @a hibernation_delay_ns hibernate: tasks wake them up only if
+ * the other worker threads are too few. Thus tasks of a few items neither wake
+ * up nor keep awake more threads than they need after the thread pool idles.
+ *
+ * @param[in,out]  threadpool            The thread pool to configure.
+ * @param[in]      warm_threads_count    The number of worker threads which never
+ *    hibernate, so that they react quickly to the first tasks after an idle
+ *    period.
+ * @param[in]      hibernation_delay_ns  The time idle worker threads sleep
+ *    before they hibernate, in nanoseconds. The default, UINT64_MAX, disables
+ *    hibernation.
+ */
+void pthreadpool_set_idle_policy(
+	pthreadpool_t threadpool,
+	size_t warm_threads_count,
+	uint64_t hibernation_delay_ns);
+
+
+/**
+ * Statistics of a thread of a thread pool, accumulated since the thread pool
+ * was created. All work of jobs processed by the calling thread as thread 0 is
+ * accounted to thread 0.
+ */
+struct pthreadpool_thread_stats {
+	/** The number of items (or tiles) processed by the thread. */
+	uint64_t items;
+	/** The number of batches of items the thread stole from segments of other threads. */
+	uint64_t steals;
+	/** The number of attempts to steal from segments of other threads which found no items. */
+	uint64_t failed_steals;
+	/** The number of iterations the thread spent spin-waiting for work. */
+	uint64_t spin_iterations;
+	/** The number of times the thread slept on a futex waiting for work. */
+	uint64_t futex_waits;
+	/** The number of times the thread hibernated (see @a pthreadpool_set_idle_policy). */
+	uint64_t hibernations;
+	/** The time the thread spent processing jobs, in nanoseconds. */
+	uint64_t busy_ns;
+	/** The time a worker thread spent waiting for jobs, in nanoseconds. Not measured for thread 0 of callers. */
+	uint64_t idle_ns;
+};
+
+/**
+ * Queries the statistics of the threads in a thread pool.
+ *
+ * Statistics are collected only if the library is built with the
+ * PTHREADPOOL_ENABLE_STATS option; otherwise, collection costs nothing, and
+ * this function fails with ENOTSUP.
+ *
+ * @param[in]  threadpool   The thread pool to query.
+ * @param[out]  stats       The array to store the statistics of threads to, in the order of thread numbers.
+ *    Elements for threads beyond the number of threads in the thread pool are zeroed.
+ * @param[in]  stats_count  The number of elements in the @a stats array.
+ *
+ * @returns  0 on success, EINVAL if @a threadpool is NULL, or ENOTSUP if
+ *    statistics are not collected.
+ */
+int pthreadpool_get_stats(
+	pthreadpool_t threadpool,
+	struct pthreadpool_thread_stats* stats,
+	size_t stats_count);
+
+/**
+ * Writes the trace of the work of the threads in a thread pool in Chrome trace
+ * event format (JSON), which chrome://tracing and Perfetto UI display.
+ *
+ * The trace has a complete event for every job a thread took part in, and for
+ * every range of items the thread processed from its own segment of a job or
+ * stole from the segment of another thread. Each thread keeps its latest 4096
+ * events in a ring buffer allocated with the thread pool, and records events
+ * without locks or memory allocation. Events are recorded only if the library
+ * is built with the PTHREADPOOL_ENABLE_TRACE option; otherwise, this function
+ * fails with ENOTSUP.
+ *
+ * @param[in]  threadpool  The thread pool to write the trace of.
+ * @param[out]  buffer     The buffer to write the null-terminated trace to, or NULL to query the size of the trace.
+ * @param[in,out]  size    On input, the size of @a buffer in bytes. On output, the size of the trace in bytes,
+ *    including the terminating null character.
+ *
+ * @returns  0 on success, ENOSPC if the trace does not fit into @a buffer (its
+ *    contents are then unspecified), EINVAL if @a threadpool or @a size is NULL,
+ *    or ENOTSUP if the trace is not recorded.
+ */
+int pthreadpool_get_trace(
+	pthreadpool_t threadpool,
+	char* buffer,
+	size_t* size);
 
 /**
  * Processes items in parallel using threads from a thread pool.
  *
  * When the call returns, all items have been processed and the thread pool is
- * ready for a new task.
+ * ready for a new task. Unless the thread pool was created with
+ * PTHREADPOOL_FLAG_DEDICATED_WORKERS, the calling thread processes items too.
  *
  * @note If multiple threads call this function with the same thread pool, the
- *    calls are serialized.
+ *    calls run concurrently, and the worker threads are shared between them.
+ *
+ * @note A call from a function which a thread pool processes (a nested call)
+ *    processes all items on the calling thread, whichever thread pool it
+ *    specifies: the outer call already keeps the threads busy. The same holds
+ *    for all other functions which process items using a thread pool.
  *
  * @param[in]  threadpool  The thread pool to use for parallelisation.
  * @param[in]  function    The function to call for each item.
@@ -58,6 +324,97 @@ void pthreadpool_compute_1d(
 	void* argument,
 	size_t range);
 
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d, using at most
+ * @a max_threads threads of the thread pool. Threads above the limit are free
+ * to process other tasks submitted to the thread pool at the same time.
+ *
+ * @param[in]  max_threads  The maximum number of threads to use, including
+ *    the calling thread if it processes items. 0 means no limit.
+ */
+void pthreadpool_compute_1d_with_max_threads(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t max_threads);
+
+/**
+ * Value of the grain argument which lets the thread pool choose the grain
+ * size from the number of items and the number of threads.
+ */
+#define PTHREADPOOL_GRAIN_AUTO 0
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d, but threads
+ * claim batches of up to @a grain consecutive items at once. Larger grains
+ * amortize the cost of scheduling over more items, at the expense of
+ * coarser load balancing.
+ *
+ * @param[in]  grain  The maximum number of items a thread claims at once,
+ *    or PTHREADPOOL_GRAIN_AUTO.
+ */
+void pthreadpool_compute_1d_with_grain(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t grain);
+
+/**
+ * Scheduling policies for pthreadpool_compute_*_with_flags functions.
+ *
+ * PTHREADPOOL_FLAG_SCHEDULE_DYNAMIC, the default, splits the items evenly
+ * between the threads, and threads claim their items one at a time, stealing
+ * items from other threads when they run out.
+ *
+ * PTHREADPOOL_FLAG_SCHEDULE_STATIC splits the items evenly between the
+ * threads, and each thread claims its whole share at once: uniform loops then
+ * pay for one atomic operation per thread rather than per item. A share of a
+ * thread which is busy elsewhere is processed by another thread.
+ *
+ * PTHREADPOOL_FLAG_SCHEDULE_GUIDED makes threads claim half of the items left
+ * in a share at once, so the claimed chunks shrink as the loop progresses.
+ */
+#define PTHREADPOOL_FLAG_SCHEDULE_DYNAMIC 0x00000000
+#define PTHREADPOOL_FLAG_SCHEDULE_STATIC  0x00000010
+#define PTHREADPOOL_FLAG_SCHEDULE_GUIDED  0x00000020
+#define PTHREADPOOL_FLAG_SCHEDULE_MASK    0x00000030
+
+/**
+ * Run the items with high priority, for latency-critical work which shares
+ * the thread pool with background work.
+ *
+ * Worker threads which look for work take items of high-priority functions
+ * before items of other functions, and return to other functions only when
+ * all items of the high-priority functions are taken. A worker thread which
+ * processes a normal-priority function leaves it for a newly submitted
+ * function after the batch of items it claimed (one item or tile with the
+ * dynamic schedule, and the whole share of the thread with the static
+ * schedule). Threads which call a pthreadpool_compute_* function keep
+ * processing that function. A few of the slots for submitted functions are
+ * reserved to high-priority functions, so that their submission does not wait
+ * for normal-priority functions to complete.
+ *
+ * Combine with the other flags of pthreadpool_compute_*_with_flags and
+ * pthreadpool_submit_*_with_flags functions.
+ */
+#define PTHREADPOOL_FLAG_PRIORITY_HIGH 0x00001000
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d, with the
+ * scheduling policy selected by @a flags.
+ *
+ * @param[in]  flags  A PTHREADPOOL_FLAG_SCHEDULE_* value, optionally combined
+ *    with PTHREADPOOL_FLAG_PRIORITY_HIGH.
+ */
+void pthreadpool_compute_1d_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags);
+
 void pthreadpool_compute_1d_tiled(
 	pthreadpool_t threadpool,
 	pthreadpool_function_1d_tiled_t function,
@@ -65,6 +422,58 @@ void pthreadpool_compute_1d_tiled(
 	size_t range,
 	size_t tile);
 
+/**
+ * Version of @a pthreadpool_compute_1d_tiled with the scheduling policy of
+ * tiles selected by @a flags (see @a pthreadpool_compute_1d_with_flags).
+ */
+void pthreadpool_compute_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags);
+
+/**
+ * Processes tiles in parallel like @a pthreadpool_compute_1d_tiled, with tile
+ * boundaries aligned to vectors of @a vector_width items.
+ *
+ * Item 0 lies @a offset items past the start of a vector. If @a offset is not
+ * 0, the first tile is the @a vector_width - @a offset items up to the start of
+ * the next vector, or all items if there are fewer. Every other tile starts at
+ * the start of a vector, and all but the last one span @a tile items rounded up
+ * to a multiple of @a vector_width. Thus a function which processes the whole
+ * vectors from the start of a tile and then the remaining items needs no peel
+ * loop for misaligned starts.
+ *
+ * @param[in]  tile          The number of items per tile before rounding.
+ * @param[in]  offset        The misalignment of item 0, in items, below
+ *    @a vector_width.
+ * @param[in]  vector_width  The number of items per vector. Must not be 0.
+ */
+void pthreadpool_compute_1d_tiled_aligned(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width);
+
+/**
+ * Version of @a pthreadpool_compute_1d_tiled_aligned with the scheduling policy
+ * of tiles selected by @a flags (see @a pthreadpool_compute_1d_with_flags).
+ */
+void pthreadpool_compute_1d_tiled_aligned_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width,
+	uint32_t flags);
+
 void pthreadpool_compute_2d(
 	pthreadpool_t threadpool,
 	pthreadpool_function_2d_t function,
@@ -72,6 +481,34 @@ void pthreadpool_compute_2d(
 	size_t range_i,
 	size_t range_j);
 
+/**
+ * Processes a 2D grid of items in parallel like @a pthreadpool_compute_2d,
+ * but threads claim batches of up to @a grain items at once, counting along
+ * the j dimension and continuing on the next i when j wraps around.
+ *
+ * @param[in]  grain  The maximum number of items a thread claims at once,
+ *    or PTHREADPOOL_GRAIN_AUTO.
+ */
+void pthreadpool_compute_2d_with_grain(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t grain);
+
+/**
+ * Version of @a pthreadpool_compute_2d with the scheduling policy selected by
+ * @a flags (see @a pthreadpool_compute_1d_with_flags).
+ */
+void pthreadpool_compute_2d_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	uint32_t flags);
+
 void pthreadpool_compute_2d_tiled(
 	pthreadpool_t threadpool,
 	pthreadpool_function_2d_tiled_t function,
@@ -81,13 +518,732 @@ void pthreadpool_compute_2d_tiled(
 	size_t tile_i,
 	size_t tile_j);
 
+/**
+ * Traversal orders of tiles for pthreadpool_compute_2d_tiled_with_flags and
+ * pthreadpool_compute_3d_tiled_with_flags. Threads claim and steal consecutive
+ * tiles in the traversal order, so the order decides which tiles a thread
+ * processes together.
+ *
+ * PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR, the default, varies the last
+ * dimension fastest.
+ *
+ * PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR varies the first dimension fastest.
+ *
+ * PTHREADPOOL_FLAG_TRAVERSAL_MORTON follows the Morton (Z-order) curve:
+ * consecutive tiles form square (or cubic) blocks of power-of-2 sizes.
+ *
+ * PTHREADPOOL_FLAG_TRAVERSAL_HILBERT follows the Hilbert curve, which forms
+ * compact blocks like the Morton curve, and keeps consecutive tiles adjacent
+ * in grids of 2**n tiles in every dimension.
+ *
+ * Curves run over the smallest power-of-2 square (or cube) which covers the
+ * grid of tiles, skipping tiles outside of the grid. Combine a traversal
+ * order with a PTHREADPOOL_FLAG_SCHEDULE_* value.
+ */
+#define PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR    0x00000000
+#define PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR 0x00000100
+#define PTHREADPOOL_FLAG_TRAVERSAL_MORTON       0x00000200
+#define PTHREADPOOL_FLAG_TRAVERSAL_HILBERT      0x00000300
+#define PTHREADPOOL_FLAG_TRAVERSAL_MASK         0x00000300
+
+/**
+ * Version of @a pthreadpool_compute_2d_tiled with the scheduling policy of
+ * tiles (see @a pthreadpool_compute_1d_with_flags) and the traversal order of
+ * tiles selected by @a flags.
+ *
+ * @param[in]  flags  A bitwise combination of a PTHREADPOOL_FLAG_SCHEDULE_*
+ *    value and a PTHREADPOOL_FLAG_TRAVERSAL_* value, optionally with
+ *    PTHREADPOOL_FLAG_PRIORITY_HIGH.
+ */
+void pthreadpool_compute_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags);
+
+/**
+ * Processes a 2D grid of tiles in parallel, giving each call a scratch memory
+ * private to the thread which executes it.
+ *
+ * The @a function is called as
+ * function(argument, thread_number, scratch, i, j, tile_i, tile_j), where
+ * thread_number is in the 0..pthreadpool_get_threads_count(threadpool)-1 range
+ * and scratch points to at least @a scratch_size bytes aligned on the cache
+ * line boundary. The scratch memory is allocated once per thread and grown on
+ * demand, so it is reused across calls and its content persists between them.
+ *
+ * @returns  0 on success, or ENOMEM if the scratch memory couldn't be
+ *    allocated. In the latter case no items are processed.
+ */
+int pthreadpool_compute_2d_tiled_with_scratch(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_with_scratch_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t scratch_size);
+
+/**
+ * Reduces items in parallel, accumulating into a private accumulator of each
+ * thread, and combining the accumulators at the end.
+ *
+ * The @a function is called as function(argument, thread_accumulator, i) for
+ * each item. Each thread accumulator starts as a copy of @a accumulator and
+ * lies in its own cache lines, so updating it causes neither atomic operations
+ * nor false sharing. When all items are processed, the thread accumulators are
+ * combined pairwise as a balanced tree, by calls
+ * combine(argument, accumulator, other_accumulator) which must fold
+ * other_accumulator into accumulator, and the result is stored in
+ * @a accumulator.
+ *
+ * The thread accumulators occupy the memory used as scratch memory by
+ * @a pthreadpool_compute_2d_tiled_with_scratch, and overwrite its content.
+ *
+ * @param[in]  threadpool        The thread pool to use for parallelisation.
+ * @param[in]  function          The function to call for each item.
+ * @param[in]  combine           The function which combines two accumulators.
+ * @param[in]  argument          The first argument passed to @a function and @a combine.
+ * @param[in,out]  accumulator   On entry, the identity value of the reduction, such as 0 for a sum.
+ *    On return, the reduction result.
+ * @param[in]  accumulator_size  The size of the accumulator, in bytes.
+ * @param[in]  range             The number of items to process.
+ *
+ * @returns  0 on success, or ENOMEM if the thread accumulators couldn't be
+ *    allocated. In the latter case no items are processed.
+ */
+int pthreadpool_reduce_1d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_reduce_1d_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range);
+
+/**
+ * Tiled version of @a pthreadpool_reduce_1d: the @a function is called as
+ * function(argument, thread_accumulator, start, tile) for each tile of up to
+ * @a tile items.
+ */
+int pthreadpool_reduce_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_reduce_1d_tiled_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range,
+	size_t tile);
+
+/**
+ * Processes a 3D grid of items in parallel using threads from a thread pool.
+ *
+ * The @a function is called as function(argument, i, j, k) once for each
+ * 0 <= i < range_i, 0 <= j < range_j, 0 <= k < range_k.
+ */
+void pthreadpool_compute_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k);
+
+/**
+ * Processes a 3D grid of tiles in parallel using threads from a thread pool.
+ *
+ * The @a function is called as function(argument, i, j, k, tile_i, tile_j, tile_k)
+ * once for each tile, where (i, j, k) is the first item of the tile and the tile
+ * sizes are clipped at the end of each range.
+ */
+void pthreadpool_compute_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k);
+
+/**
+ * Version of @a pthreadpool_compute_3d_tiled with the scheduling policy and
+ * the traversal order of tiles selected by @a flags (see
+ * @a pthreadpool_compute_2d_tiled_with_flags).
+ */
+void pthreadpool_compute_3d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k,
+	uint32_t flags);
+
+/**
+ * Processes a 4D grid of items in parallel using threads from a thread pool,
+ * with tiling of the two innermost dimensions.
+ *
+ * The @a function is called as function(argument, i, j, k, l, tile_k, tile_l)
+ * once for each 0 <= i < range_i, 0 <= j < range_j, and each tile of the
+ * range_k x range_l plane, where (k, l) is the first item of the tile and the
+ * tile sizes are clipped at the end of each range.
+ */
+void pthreadpool_compute_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l);
+
+/**
+ * Processes a 5D grid of items in parallel using threads from a thread pool,
+ * with tiling of the two innermost dimensions.
+ *
+ * The @a function is called as function(argument, i, j, k, l, m, tile_l, tile_m),
+ * following the conventions of @a pthreadpool_compute_4d_tiled.
+ */
+void pthreadpool_compute_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m);
+
+/**
+ * Processes a 6D grid of items in parallel using threads from a thread pool,
+ * with tiling of the two innermost dimensions.
+ *
+ * The @a function is called as function(argument, i, j, k, l, m, n, tile_m, tile_n),
+ * following the conventions of @a pthreadpool_compute_4d_tiled.
+ */
+void pthreadpool_compute_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n);
+
+/**
+ * Submits items for parallel processing using threads from a thread pool,
+ * without waiting for their completion.
+ *
+ * Submitted functions run concurrently with each other and with synchronous
+ * calls, and the worker threads are shared between the running functions, so
+ * no order of their completion is guaranteed. Up to 16 functions can be
+ * submitted and not completed; when all slots are busy, the call blocks until
+ * one of the functions completes. The @a function and its @a argument must
+ * remain valid until the submitted function completes.
+ *
+ * A call from a function which a thread pool processes processes the items on
+ * the calling thread before it returns, as with a NULL thread pool.
+ *
+ * @param[in]  threadpool  The thread pool to use for parallelisation.
+ *    If NULL, the items are processed on the calling thread before the call returns.
+ * @param[in]  function    The function to call for each item.
+ * @param[in]  argument    The first argument passed to the @a function.
+ * @param[in]  range       The number of items to process.
+ *
+ * @returns  A handle to pass to @a pthreadpool_wait or @a pthreadpool_test.
+ */
+pthreadpool_completion_t pthreadpool_submit_1d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range);
+
+/**
+ * Version of @a pthreadpool_submit_1d with the scheduling policy and the
+ * priority selected by @a flags (see @a pthreadpool_compute_1d_with_flags).
+ */
+pthreadpool_completion_t pthreadpool_submit_1d_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_1d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile);
+
+/**
+ * Version of @a pthreadpool_submit_1d_tiled with the scheduling policy and
+ * the priority selected by @a flags (see @a pthreadpool_compute_1d_with_flags).
+ */
+pthreadpool_completion_t pthreadpool_submit_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_2d, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_2d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_2d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j);
+
+/**
+ * Version of @a pthreadpool_submit_2d_tiled with the scheduling policy, the
+ * traversal order and the priority of tiles selected by @a flags (see
+ * @a pthreadpool_compute_2d_tiled_with_flags).
+ */
+pthreadpool_completion_t pthreadpool_submit_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_3d, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_3d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_4d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_5d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m);
+
+/**
+ * Asynchronous version of @a pthreadpool_compute_6d_tiled, following the conventions of @a pthreadpool_submit_1d.
+ */
+pthreadpool_completion_t pthreadpool_submit_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n);
+
+/**
+ * Waits until a submitted function completes.
+ *
+ * Functions submitted before it may still be running: wait for each function
+ * whose results are needed.
+ *
+ * @param[in]  threadpool  The thread pool the function was submitted to.
+ * @param[in]  completion  The handle returned by the pthreadpool_submit_* call.
+ */
+void pthreadpool_wait(pthreadpool_t threadpool, pthreadpool_completion_t completion);
+
+/**
+ * Checks if a submitted function completed, without blocking.
+ *
+ * @param[in]  threadpool  The thread pool the function was submitted to.
+ * @param[in]  completion  The handle returned by the pthreadpool_submit_* call.
+ *
+ * @returns  Non-zero if the function completed, and 0 if it is pending or running.
+ */
+int pthreadpool_test(pthreadpool_t threadpool, pthreadpool_completion_t completion);
+
+/**
+ * Cancels a submitted function: threads stop taking its items, and the
+ * function completes as soon as the items which threads already took are
+ * processed. Items which no thread took are never processed.
+ *
+ * Has no effect if the function already completed. The caller still waits
+ * for completion with @a pthreadpool_wait before releasing the resources
+ * which the function uses.
+ *
+ * @param[in]  threadpool  The thread pool the function was submitted to.
+ * @param[in]  completion  The handle returned by the pthreadpool_submit_* call.
+ */
+void pthreadpool_cancel(pthreadpool_t threadpool, pthreadpool_completion_t completion);
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d, until the
+ * function returns non-zero for an item.
+ *
+ * Once an item returns non-zero, threads stop taking new items, and the call
+ * returns as soon as the items which threads already started are processed.
+ * Suits searches and validations which can stop at the first match or error.
+ * Threads check for cancellation before every item, so which items after
+ * the cancelling one are processed is unspecified.
+ *
+ * @param[in]  threadpool  The thread pool to use for parallelisation.
+ * @param[in]  function    The function to call for each item. Returns
+ *    non-zero to cancel the items which are not started yet.
+ * @param[in]  argument    The first argument passed to the @a function.
+ * @param[in]  range       The number of items to process.
+ *
+ * @returns  Non-zero if some item cancelled the call, and 0 if the function
+ *    returned 0 for all items.
+ */
+int pthreadpool_compute_1d_cancellable(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_cancellable_t function,
+	void* argument,
+	size_t range);
+
+/**
+ * Tiled version of @a pthreadpool_compute_1d_cancellable, which processes
+ * tiles like @a pthreadpool_compute_1d_tiled until the function returns
+ * non-zero for a tile.
+ */
+int pthreadpool_compute_1d_tiled_cancellable(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_cancellable_t function,
+	void* argument,
+	size_t range,
+	size_t tile);
+
+/**
+ * Kind of a parallel loop in a batch of loops.
+ */
+enum pthreadpool_loop_type {
+	/** Processes items like @a pthreadpool_compute_1d. Uses range_i. */
+	pthreadpool_loop_1d = 0,
+	/** Processes tiles like @a pthreadpool_compute_1d_tiled. Uses range_i and tile_i. */
+	pthreadpool_loop_1d_tiled,
+	/** Processes items like @a pthreadpool_compute_2d. Uses range_i and range_j. */
+	pthreadpool_loop_2d,
+	/** Processes tiles like @a pthreadpool_compute_2d_tiled. Uses all ranges and tiles. */
+	pthreadpool_loop_2d_tiled,
+};
+
+/**
+ * Parallel loop in a batch of loops processed by @a pthreadpool_compute_batch.
+ */
+struct pthreadpool_loop {
+	/**
+	 * The kind of the loop, which selects the member of @a function and the used ranges and tiles.
+	 */
+	enum pthreadpool_loop_type type;
+	/**
+	 * The function to call for each item or tile.
+	 */
+	union {
+		pthreadpool_function_1d_t function_1d;
+		pthreadpool_function_1d_tiled_t function_1d_tiled;
+		pthreadpool_function_2d_t function_2d;
+		pthreadpool_function_2d_tiled_t function_2d_tiled;
+	} function;
+	/**
+	 * The first argument passed to the function.
+	 */
+	void* argument;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+/**
+ * Processes several independent loops in parallel using threads from a thread
+ * pool, and waits until all of them complete.
+ *
+ * The loops are dispatched to the threads together, as a single loop over all
+ * their items, and threads which finish their part of one loop steal items of
+ * any loop in the batch. This amortizes the cost of the dispatch over the
+ * loops, and is most useful for small loops.
+ *
+ * The loops may run in any order or concurrently, and must not depend on each
+ * other. Batches of more than 16 loops are dispatched in groups of 16 loops.
+ *
+ * @param[in]  threadpool   The thread pool to use for parallelisation.
+ *    If NULL, the loops are processed one after another on the calling thread.
+ * @param[in]  loops        The loops to process.
+ * @param[in]  loops_count  The number of elements in the @a loops array.
+ */
+void pthreadpool_compute_batch(
+	pthreadpool_t threadpool,
+	const struct pthreadpool_loop* loops,
+	size_t loops_count);
+
+/**
+ * Creates a plan which processes items in parallel like
+ * @a pthreadpool_compute_1d, for repeated execution with different arguments.
+ *
+ * A plan precomputes the parameters of the loop and the initial split of the
+ * items between the threads, so that @a pthreadpool_plan_execute only
+ * publishes the loop to the threads. The split is recomputed if the number of
+ * threads changes (see @a pthreadpool_set_threads_count).
+ *
+ * @param[in]  threadpool  The thread pool to execute the plan on. Must outlive the plan.
+ *    If NULL, the plan is executed on the calling thread.
+ * @param[in]  function    The function to call for each item.
+ * @param[in]  range       The number of items to process.
+ *
+ * @returns  The new plan, or NULL if memory can't be allocated.
+ */
+pthreadpool_plan_t pthreadpool_plan_create_1d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_t function,
+	size_t range);
+
+/**
+ * Creates a plan which processes tiles like @a pthreadpool_compute_1d_tiled,
+ * following the conventions of @a pthreadpool_plan_create_1d.
+ */
+pthreadpool_plan_t pthreadpool_plan_create_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	size_t range,
+	size_t tile);
+
+/**
+ * Creates a plan which processes items like @a pthreadpool_compute_2d,
+ * following the conventions of @a pthreadpool_plan_create_1d.
+ */
+pthreadpool_plan_t pthreadpool_plan_create_2d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_t function,
+	size_t range_i,
+	size_t range_j);
+
+/**
+ * Creates a plan which processes tiles like @a pthreadpool_compute_2d_tiled,
+ * following the conventions of @a pthreadpool_plan_create_1d.
+ */
+pthreadpool_plan_t pthreadpool_plan_create_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j);
+
+/**
+ * Processes the items of the plan, and waits until they are processed.
+ *
+ * Executions of the same plan must not overlap: threads which execute the same
+ * loop concurrently need a plan each.
+ *
+ * @param[in,out]  plan  The plan to execute.
+ * @param[in]  argument  The first argument passed to the function of the plan.
+ */
+void pthreadpool_plan_execute(pthreadpool_plan_t plan, void* argument);
+
+/**
+ * Releases the plan. The plan must not be executing.
+ *
+ * @param[in,out]  plan  The plan to release. NULL is ignored.
+ */
+void pthreadpool_plan_destroy(pthreadpool_plan_t plan);
+
+/**
+ * Creates an empty graph of parallel loops.
+ *
+ * A graph describes a sequence of parallel loops (nodes), where a loop may
+ * depend on the completion of any earlier loops. When the graph runs, the
+ * threads start processing a node as soon as all nodes it depends on complete,
+ * and process independent nodes concurrently, rather than waiting for all
+ * threads to finish a loop before starting the next one.
+ *
+ * A graph is not bound to a thread pool, and can run any number of times.
+ *
+ * @returns  The new graph, or NULL if memory can't be allocated.
+ */
+pthreadpool_graph_t pthreadpool_graph_create(void);
+
+/**
+ * Adds a node which processes the items of a @a pthreadpool_compute_1d loop
+ * to the graph.
+ *
+ * @param[in,out]  graph  The graph to add the node to.
+ * @param[in]  function   The function to call for each item.
+ * @param[in]  argument   The first argument passed to the @a function.
+ * @param[in]  range      The number of items to process.
+ * @param[out]  node      The identifier of the new node, to pass to @a pthreadpool_graph_add_dependency.
+ *    Nodes are numbered consecutively from 0 in the order they are added.
+ *
+ * @returns  0 on success, or ENOMEM if memory can't be allocated.
+ */
+int pthreadpool_graph_add_1d(
+	pthreadpool_graph_t graph,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t* node);
+
+/**
+ * Adds a node which processes the tiles of a @a pthreadpool_compute_1d_tiled
+ * loop to the graph, following the conventions of @a pthreadpool_graph_add_1d.
+ */
+int pthreadpool_graph_add_1d_tiled(
+	pthreadpool_graph_t graph,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t* node);
+
+/**
+ * Adds a node which processes the items of a @a pthreadpool_compute_2d loop
+ * to the graph, following the conventions of @a pthreadpool_graph_add_1d.
+ */
+int pthreadpool_graph_add_2d(
+	pthreadpool_graph_t graph,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t* node);
+
+/**
+ * Adds a node which processes the tiles of a @a pthreadpool_compute_2d_tiled
+ * loop to the graph, following the conventions of @a pthreadpool_graph_add_1d.
+ */
+int pthreadpool_graph_add_2d_tiled(
+	pthreadpool_graph_t graph,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t* node);
+
+/**
+ * Makes a node of the graph wait for the completion of an earlier node.
+ *
+ * No item of @a node is processed until all items of @a dependency are
+ * processed, and the results of @a dependency are visible to @a node.
+ *
+ * @param[in,out]  graph   The graph which contains both nodes.
+ * @param[in]  node        The node which depends on @a dependency.
+ * @param[in]  dependency  The node which must complete first. Must be added to
+ *    the graph before @a node, which keeps the graph free of cycles.
+ *
+ * @returns  0 on success, EINVAL if @a dependency is not a node added before
+ *    @a node, or ENOMEM if memory can't be allocated.
+ */
+int pthreadpool_graph_add_dependency(pthreadpool_graph_t graph, size_t node, size_t dependency);
+
+/**
+ * Processes all nodes of the graph in parallel using threads from a thread
+ * pool, and waits until they complete.
+ *
+ * Runs of the same graph must not overlap, and the graph must not be modified
+ * while it runs. Runs of different graphs, and other functions, may run on the
+ * same thread pool concurrently.
+ *
+ * @param[in]  threadpool  The thread pool to use for parallelisation.
+ *    If NULL, the nodes are processed one after another, in the order they were added.
+ * @param[in,out]  graph   The graph to run.
+ *
+ * @returns  0 on success, or ENOMEM if memory can't be allocated. In the
+ *    latter case no nodes are processed.
+ */
+int pthreadpool_graph_run(pthreadpool_t threadpool, pthreadpool_graph_t graph);
+
+/**
+ * Releases the graph. The graph must not be running.
+ *
+ * @param[in,out]  graph  The graph to release. NULL is ignored.
+ */
+void pthreadpool_graph_destroy(pthreadpool_graph_t graph);
+
 /**
  * Terminates threads in the thread pool and releases associated resources.
  *
  * @warning  Accessing the thread pool after a call to this function constitutes
  *    undefined behaviour and may cause data corruption.
  *
- * @param[in,out]  threadpool  The thread pool to destroy.
+ * @param[in,out]  threadpool  The thread pool to destroy. NULL and the thread
+ *    pool returned by @a pthreadpool_get_default are ignored.
  */
 void pthreadpool_destroy(pthreadpool_t threadpool);
 
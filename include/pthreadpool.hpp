@@ -0,0 +1,248 @@
+#ifndef PTHREADPOOL_HPP
+#define PTHREADPOOL_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pthreadpool.h>
+
+/*
+ * C++ interface to the pthreadpool_compute_* functions, which take arbitrary callables (e.g. lambdas) instead of
+ * a function pointer and an argument. The overloads have the names of the C functions, without the argument.
+ *
+ * Each callable type instantiates its own trampoline, which calls the callable for all items of a tile in a loop.
+ * The thread pool calls the trampoline indirectly once per tile, and the compiler can inline the callable into it.
+ * Callables which process items rather than tiles get tiles of several items, so that the threads claim
+ * PTHREADPOOL_CXX_TILES_PER_THREAD tiles per thread on average.
+ *
+ * Callables are called concurrently from several threads through a const reference, and must remain valid until
+ * the call returns.
+ */
+
+/* The number of tiles per thread which loops over items are split into */
+#define PTHREADPOOL_CXX_TILES_PER_THREAD 32
+
+namespace pthreadpool_detail {
+
+/* Returns the number of items per tile for a loop of the specified number of items */
+inline size_t get_items_per_tile(pthreadpool_t threadpool, size_t items) {
+	const size_t tiles = pthreadpool_get_threads_count(threadpool) * PTHREADPOOL_CXX_TILES_PER_THREAD;
+	const size_t items_per_tile = items / tiles;
+	return items_per_tile != 0 ? items_per_tile : 1;
+}
+
+template <class Function>
+inline void* get_argument(const Function& function) {
+	return const_cast<void*>(static_cast<const void*>(&function));
+}
+
+template <class Function>
+void compute_1d_tile(void* argument, size_t start, size_t tile) {
+	const Function& function = *static_cast<const Function*>(argument);
+	for (size_t i = start; i < start + tile; i++) {
+		function(i);
+	}
+}
+
+template <class Function>
+void compute_1d_tiled(void* argument, size_t start, size_t tile) {
+	const Function& function = *static_cast<const Function*>(argument);
+	function(start, tile);
+}
+
+template <class Function>
+int compute_1d_tile_cancellable(void* argument, size_t start, size_t tile) {
+	const Function& function = *static_cast<const Function*>(argument);
+	for (size_t i = start; i < start + tile; i++) {
+		if (function(i)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+template <class Function>
+void compute_2d_tile(void* argument, size_t start_i, size_t start_j, size_t tile_i, size_t tile_j) {
+	const Function& function = *static_cast<const Function*>(argument);
+	for (size_t i = start_i; i < start_i + tile_i; i++) {
+		for (size_t j = start_j; j < start_j + tile_j; j++) {
+			function(i, j);
+		}
+	}
+}
+
+template <class Function>
+void compute_2d_tiled(void* argument, size_t start_i, size_t start_j, size_t tile_i, size_t tile_j) {
+	const Function& function = *static_cast<const Function*>(argument);
+	function(start_i, start_j, tile_i, tile_j);
+}
+
+} /* namespace pthreadpool_detail */
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d, calling
+ * function(i) for every item i in [0, range).
+ */
+template <class Function>
+inline void pthreadpool_compute_1d_with_flags(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled_with_flags(threadpool, pthreadpool_detail::compute_1d_tile<Function>,
+		pthreadpool_detail::get_argument(function), range,
+		pthreadpool_detail::get_items_per_tile(threadpool, range), flags);
+}
+
+template <class Function>
+inline void pthreadpool_compute_1d(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range)
+{
+	pthreadpool_compute_1d_with_flags(threadpool, function, range, 0);
+}
+
+/**
+ * Processes tiles in parallel like @a pthreadpool_compute_1d_tiled, calling
+ * function(start, tile) for every tile.
+ */
+template <class Function>
+inline void pthreadpool_compute_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range,
+	size_t tile,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled_with_flags(threadpool, pthreadpool_detail::compute_1d_tiled<Function>,
+		pthreadpool_detail::get_argument(function), range, tile, flags);
+}
+
+template <class Function>
+inline void pthreadpool_compute_1d_tiled(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range,
+	size_t tile)
+{
+	pthreadpool_compute_1d_tiled_with_flags(threadpool, function, range, tile, 0);
+}
+
+/**
+ * Processes tiles in parallel like @a pthreadpool_compute_1d_tiled_aligned,
+ * calling function(start, tile) for every tile.
+ */
+template <class Function>
+inline void pthreadpool_compute_1d_tiled_aligned_with_flags(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled_aligned_with_flags(threadpool, pthreadpool_detail::compute_1d_tiled<Function>,
+		pthreadpool_detail::get_argument(function), range, tile, offset, vector_width, flags);
+}
+
+template <class Function>
+inline void pthreadpool_compute_1d_tiled_aligned(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width)
+{
+	pthreadpool_compute_1d_tiled_aligned_with_flags(threadpool, function, range, tile, offset, vector_width, 0);
+}
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_1d_cancellable,
+ * calling function(i) for items i in [0, range) until it returns true.
+ * Items of a tile after the cancelling one are not processed.
+ *
+ * @returns  true if some item cancelled the call.
+ */
+template <class Function>
+inline bool pthreadpool_compute_1d_cancellable(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range)
+{
+	return pthreadpool_compute_1d_tiled_cancellable(threadpool, pthreadpool_detail::compute_1d_tile_cancellable<Function>,
+		pthreadpool_detail::get_argument(function), range,
+		pthreadpool_detail::get_items_per_tile(threadpool, range)) != 0;
+}
+
+/**
+ * Processes items in parallel like @a pthreadpool_compute_2d, calling
+ * function(i, j) for every item (i, j) in [0, range_i) x [0, range_j).
+ * Tiles span whole rows of j if rows are short, and parts of a row otherwise.
+ */
+template <class Function>
+inline void pthreadpool_compute_2d_with_flags(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range_i,
+	size_t range_j,
+	uint32_t flags)
+{
+	if (range_i == 0 || range_j == 0) {
+		return;
+	}
+	const size_t items_per_tile = pthreadpool_detail::get_items_per_tile(threadpool, range_i * range_j);
+	size_t tile_i = 1;
+	size_t tile_j = items_per_tile;
+	if (items_per_tile >= range_j) {
+		tile_i = items_per_tile / range_j;
+		tile_j = range_j;
+	}
+	pthreadpool_compute_2d_tiled_with_flags(threadpool, pthreadpool_detail::compute_2d_tile<Function>,
+		pthreadpool_detail::get_argument(function), range_i, range_j, tile_i, tile_j, flags);
+}
+
+template <class Function>
+inline void pthreadpool_compute_2d(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range_i,
+	size_t range_j)
+{
+	pthreadpool_compute_2d_with_flags(threadpool, function, range_i, range_j, 0);
+}
+
+/**
+ * Processes tiles in parallel like @a pthreadpool_compute_2d_tiled, calling
+ * function(start_i, start_j, tile_i, tile_j) for every tile.
+ */
+template <class Function>
+inline void pthreadpool_compute_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags)
+{
+	pthreadpool_compute_2d_tiled_with_flags(threadpool, pthreadpool_detail::compute_2d_tiled<Function>,
+		pthreadpool_detail::get_argument(function), range_i, range_j, tile_i, tile_j, flags);
+}
+
+template <class Function>
+inline void pthreadpool_compute_2d_tiled(
+	pthreadpool_t threadpool,
+	const Function& function,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	pthreadpool_compute_2d_tiled_with_flags(threadpool, function, range_i, range_j, tile_i, tile_j, 0);
+}
+
+#endif /* PTHREADPOOL_HPP */
@@ -9,7 +9,7 @@ include $(BUILD_STATIC_LIBRARY)
 
 include $(CLEAR_VARS)
 LOCAL_MODULE := pthreadpool
-LOCAL_SRC_FILES := $(LOCAL_PATH)/src/threadpool-pthreads.c
+LOCAL_SRC_FILES := $(LOCAL_PATH)/src/portable-api.c $(LOCAL_PATH)/src/threadpool-pthreads.c
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/include
 LOCAL_C_INCLUDES := $(LOCAL_EXPORT_C_INCLUDES) $(LOCAL_PATH)/deps/fxdiv/include
 include $(BUILD_STATIC_LIBRARY)
@@ -0,0 +1,3721 @@
+/* Standard C headers */
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Dependencies */
+#include <fxdiv.h>
+
+/* Library header */
+#include <pthreadpool.h>
+
+/* Internal headers */
+#include "threadpool-object.h"
+#include "threadpool-utils.h"
+
+
+static void checkin_worker_thread(struct pthreadpool* threadpool) {
+	if (__atomic_sub_fetch(&threadpool->active_threads, 1, __ATOMIC_ACQ_REL) == 0) {
+		/*
+		 * Sequentially consistent ordering pairs with the registration of the waiter in wait_worker_threads:
+		 * either the waiter observes has_active_threads == 0, or we observe the waiter and wake it up.
+		 */
+		__atomic_store_n(&threadpool->has_active_threads, 0, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&threadpool->completion_waiters, __ATOMIC_SEQ_CST) != 0) {
+			pthreadpool_futex_wake_all(&threadpool->has_active_threads);
+		}
+	}
+}
+
+static void wait_worker_threads(struct pthreadpool* threadpool) {
+	/* Spin-wait for a while: if the threads complete soon, this avoids a futex round-trip on both sides */
+	const uint32_t spin_wait_iterations = __atomic_load_n(&threadpool->spin_wait_iterations, __ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < spin_wait_iterations; i++) {
+		if (__atomic_load_n(&threadpool->has_active_threads, __ATOMIC_ACQUIRE) == 0) {
+			return;
+		}
+		pthreadpool_spin_wait_hint();
+	}
+
+	/* The threads are still busy: register as a waiter and fall back to sleeping on a futex */
+	__atomic_add_fetch(&threadpool->completion_waiters, 1, __ATOMIC_SEQ_CST);
+	while (__atomic_load_n(&threadpool->has_active_threads, __ATOMIC_SEQ_CST) != 0) {
+		pthreadpool_futex_wait(&threadpool->has_active_threads, 1);
+	}
+	__atomic_sub_fetch(&threadpool->completion_waiters, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Wakes up sleeping worker threads to look for the last command: the waiters for a new command first, and then
+ * hibernating worker threads if the other worker threads are fewer than wakeup_threads_count.
+ * Worker threads which spin-wait or process jobs observe the command without a wake-up.
+ */
+static void wake_idle_worker_threads(struct pthreadpool* threadpool, size_t wakeup_threads_count) {
+	const uint32_t command_waiters = __atomic_load_n(&threadpool->command_waiters, __ATOMIC_SEQ_CST);
+	if (command_waiters != 0) {
+		if (wakeup_threads_count >= command_waiters) {
+			pthreadpool_futex_wake_all(&threadpool->command);
+		} else {
+			pthreadpool_futex_wake(&threadpool->command, (uint32_t) wakeup_threads_count);
+		}
+	}
+
+	const uint32_t hibernating_threads = __atomic_load_n(&threadpool->hibernating_threads, __ATOMIC_SEQ_CST);
+	if (hibernating_threads != 0) {
+		/* Worker threads which start lazily may hibernate before they are counted as started */
+		const size_t started_threads_count =
+			__atomic_load_n(&threadpool->started_threads_end, __ATOMIC_RELAXED) - threadpool->workers_start;
+		const size_t awake_threads = started_threads_count > hibernating_threads ? started_threads_count - hibernating_threads : 0;
+		if (wakeup_threads_count > awake_threads) {
+			__atomic_add_fetch(&threadpool->hibernation_events, 1, __ATOMIC_SEQ_CST);
+			if (wakeup_threads_count - awake_threads >= hibernating_threads) {
+				pthreadpool_futex_wake_all(&threadpool->hibernation_events);
+			} else {
+				pthreadpool_futex_wake(&threadpool->hibernation_events, (uint32_t) (wakeup_threads_count - awake_threads));
+			}
+		}
+	}
+}
+
+/*
+ * Submits a new command, and wakes up as many sleeping worker threads as needed for wakeup_threads_count worker
+ * threads to look for it. SIZE_MAX wakes up all worker threads.
+ */
+static void wakeup_worker_threads(struct pthreadpool* threadpool, uint32_t command, size_t wakeup_threads_count) {
+	/*
+	 * Sequentially consistent ordering pairs with the registration of waiters in wait_for_new_command and
+	 * hibernate_worker_thread: either a worker observes the new command, or we observe the worker and wake it up.
+	 * The release half of the store also publishes the command parameters.
+	 */
+	__atomic_store_n(&threadpool->command, command, __ATOMIC_SEQ_CST);
+	wake_idle_worker_threads(threadpool, wakeup_threads_count);
+}
+
+/*
+ * Atomically decrements the value by up to max_decrement, but not below zero. If guided is true, decrements by
+ * half of the value instead, if this is more than max_decrement.
+ * Returns the amount the value was decremented by, which is zero only if the value was zero.
+ */
+static inline size_t atomic_decrement(size_t* value, size_t max_decrement, bool guided) {
+	size_t actual_value = __atomic_load_n(value, __ATOMIC_RELAXED);
+	while (actual_value != 0) {
+		size_t decrement = min(actual_value, max_decrement);
+		if (guided && actual_value / 2 > decrement) {
+			decrement = actual_value / 2;
+		}
+		if (__atomic_compare_exchange_n(value, &actual_value, actual_value - decrement,
+			true /* weak */, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			return decrement;
+		}
+	}
+	return 0;
+}
+
+/* Item processing function which also receives the thread that processes the item */
+typedef void (*thread_function_1d_t)(void*, struct thread_info*, size_t);
+
+/* Returns the thread after the specified one in the group of threads [group_start, group_end), wrapping around */
+static inline size_t next_thread_in_group(size_t tid, size_t group_start, size_t group_end) {
+	return tid + 1 == group_end ? group_start : tid + 1;
+}
+
+/* Returns the number of threads which process new jobs */
+static inline size_t get_enabled_threads_count(struct pthreadpool* threadpool) {
+	return (size_t) __atomic_load_n(&threadpool->enabled_threads_count, __ATOMIC_RELAXED);
+}
+
+/* Checks if the calling thread processes a job of some thread pool, i.e. is called from an item processing function */
+static inline bool is_nested_call(void) {
+	return pthreadpool_get_current_threadpool() != NULL;
+}
+
+/*
+ * Checks if a call must process its items sequentially on the calling thread: if there is no thread pool, or only one
+ * enabled thread, or the call is nested. Nested calls on the same thread pool would wait for the threads which process
+ * the outer job, and calls on another thread pool would oversubscribe the processors.
+ */
+static inline bool is_sequential_call(struct pthreadpool* threadpool) {
+	return threadpool == NULL || get_enabled_threads_count(threadpool) <= 1 || is_nested_call();
+}
+
+/* Checks if a job was submitted to the thread pool after the thread observed the specified command */
+static inline bool has_new_command(struct pthreadpool* threadpool, uint32_t command) {
+	return __atomic_load_n(&threadpool->command, __ATOMIC_RELAXED) != command;
+}
+
+#if PTHREADPOOL_ENABLE_TRACE
+/*
+ * Records a trace event in the ring buffer of the thread, overwriting the oldest record if the buffer is full.
+ * Safe to call concurrently for the same thread, and never blocks.
+ */
+static void record_trace_event(
+	struct thread_info* thread,
+	enum trace_event_type type,
+	uint32_t value,
+	uint64_t start_ns,
+	uint64_t end_ns,
+	size_t range_start,
+	size_t range_length)
+{
+	const uint64_t position = __atomic_fetch_add(&thread->trace_events_count, 1, __ATOMIC_RELAXED);
+	struct trace_event* event = &thread->trace_events[position % PTHREADPOOL_TRACE_EVENTS];
+	/* Readers which see the fields below also see the odd sequence number, and discard the record */
+	__atomic_store_n(&event->sequence, 2 * position + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&event->start_ns, start_ns, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->end_ns, end_ns, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->range_start, (uint64_t) range_start, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->range_length, (uint64_t) range_length, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->type, (uint32_t) type, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->value, value, __ATOMIC_RELAXED);
+	__atomic_store_n(&event->sequence, 2 * position + 2, __ATOMIC_RELEASE);
+}
+#endif
+
+/* Checks if the job was cancelled. The flag is valid only while the thread holds unaccounted items of the job. */
+static inline bool is_job_cancelled(const uint32_t* cancellation) {
+	return __atomic_load_n(cancellation, __ATOMIC_RELAXED) != 0;
+}
+
+/*
+ * Processes the items [batch_start, batch_start + batch_size). If cancellable is true, the function returns non-zero
+ * to cancel the job, and the items of the batch after it, or after another thread cancels the job, are skipped.
+ */
+static inline __attribute__((__always_inline__)) void process_items_1d(
+	struct thread_info* thread,
+	void* function,
+	void* argument,
+	bool pass_thread,
+	bool cancellable,
+	uint32_t* cancellation,
+	size_t batch_start,
+	size_t batch_size)
+{
+	for (size_t item_id = batch_start; item_id < batch_start + batch_size; item_id++) {
+		if (cancellable) {
+			if (is_job_cancelled(cancellation)) {
+				break;
+			}
+			if (((pthreadpool_function_1d_cancellable_t) function)(argument, item_id) != 0) {
+				__atomic_store_n(cancellation, 1, __ATOMIC_RELAXED);
+				break;
+			}
+		} else if (pass_thread) {
+			((thread_function_1d_t) function)(argument, thread, item_id);
+		} else {
+			((pthreadpool_function_1d_t) function)(argument, item_id);
+		}
+	}
+	PTHREADPOOL_STATS_ADD(thread, items, batch_size);
+}
+
+/*
+ * Takes all items left in the segments of a cancelled job without processing them, so that the job completes when the
+ * items which threads took before the cancellation are processed. Returns the number of items taken.
+ */
+static size_t skip_job_items(struct job* job) {
+	size_t skipped_items = 0;
+	for (size_t tid = 0; tid < job->threads_count; tid++) {
+		skipped_items += atomic_decrement(&job->segments[tid].range_length, SIZE_MAX, false);
+	}
+	/* All items are taken: threads which look for work need not join this job anymore */
+	__atomic_store_n(&job->exhausted, 1, __ATOMIC_RELAXED);
+	return skipped_items;
+}
+
+/*
+ * Steals batches of up to grain items (or of half of the remaining items if guided) from the end of the segment of
+ * the thread with the specified number, and adds their number to *processed_items. Returns false if the thread
+ * stopped stealing because a new job was submitted to the thread pool, or because the job was cancelled.
+ */
+static inline __attribute__((__always_inline__)) bool steal_items_1d(
+	struct pthreadpool* threadpool,
+	uint32_t command,
+	struct thread_info* thread,
+	struct job_segment* segments,
+	size_t victim_thread_number,
+	void* function,
+	void* argument,
+	bool pass_thread,
+	bool cancellable,
+	uint32_t* cancellation,
+	size_t grain,
+	bool guided,
+	size_t* processed_items)
+{
+	struct job_segment* segment = &segments[victim_thread_number];
+	size_t batch_size;
+	if ((batch_size = atomic_decrement(&segment->range_length, grain, guided)) == 0) {
+		PTHREADPOOL_STATS_ADD(thread, failed_steals, 1);
+		return true;
+	}
+	do {
+		const size_t batch_start = __atomic_sub_fetch(&segment->range_end, batch_size, __ATOMIC_RELAXED);
+		if (is_job_cancelled(cancellation)) {
+			*processed_items += batch_size;
+			return false;
+		}
+		const uint64_t steal_start = PTHREADPOOL_TRACE_TIMESTAMP();
+		process_items_1d(thread, function, argument, pass_thread, cancellable, cancellation, batch_start, batch_size);
+		PTHREADPOOL_TRACE_EVENT(thread, trace_event_steal, (uint32_t) victim_thread_number,
+			steal_start, PTHREADPOOL_TRACE_TIMESTAMP(), batch_start, batch_size);
+		PTHREADPOOL_STATS_ADD(thread, steals, 1);
+		*processed_items += batch_size;
+		if (has_new_command(threadpool, command)) {
+			return false;
+		}
+	} while ((batch_size = atomic_decrement(&segment->range_length, grain, guided)) != 0);
+	return true;
+}
+
+/*
+ * Returns the number of items a thread which stopped stealing accounts for: if the job was cancelled, also the items
+ * it takes to skip them. A thread stops stealing after it takes items, so the cancellation flag is still valid.
+ */
+static inline size_t leave_stolen_items(struct job* job, const uint32_t* cancellation, size_t processed_items) {
+	if (is_job_cancelled(cancellation)) {
+		processed_items += skip_job_items(job);
+	}
+	return processed_items;
+}
+
+static inline __attribute__((__always_inline__)) size_t thread_compute_1d_generic(
+	struct pthreadpool* threadpool,
+	struct job* job,
+	struct thread_info* thread,
+	bool pass_thread,
+	bool cancellable)
+{
+	void *const function = job->function;
+	void *const argument = job->argument;
+	struct job_segment *const segments = job->segments;
+	uint32_t *const cancellation = job->cancellation;
+	const size_t grain = job->grain;
+	const bool guided = job->guided != 0;
+	/* A thread leaves the job when a new job is submitted, so that worker threads spread across the running jobs */
+	const uint32_t command = __atomic_load_n(&threadpool->command, __ATOMIC_RELAXED);
+	size_t processed_items = 0;
+
+	/* Process thread's own segment of items */
+	const size_t thread_number = thread->thread_number;
+	struct job_segment* segment = &segments[thread_number];
+	const size_t own_range_start = __atomic_load_n(&segment->range_start, __ATOMIC_RELAXED);
+	const uint64_t own_range_start_ns = PTHREADPOOL_TRACE_TIMESTAMP();
+	size_t range_start = own_range_start;
+	size_t batch_size;
+	bool cancelled = false;
+	while ((batch_size = atomic_decrement(&segment->range_length, grain, guided)) != 0) {
+		/* Taken items keep the job from completing: the cancellation flag is valid until they are accounted for */
+		cancelled = is_job_cancelled(cancellation);
+		if (!cancelled) {
+			process_items_1d(thread, function, argument, pass_thread, cancellable, cancellation, range_start, batch_size);
+		}
+		range_start += batch_size;
+		processed_items += batch_size;
+		if (cancelled || has_new_command(threadpool, command)) {
+			break;
+		}
+	}
+	__atomic_store_n(&segment->range_start, range_start, __ATOMIC_RELAXED);
+	if (range_start != own_range_start) {
+		PTHREADPOOL_TRACE_EVENT(thread, trace_event_items, (uint32_t) thread_number,
+			own_range_start_ns, PTHREADPOOL_TRACE_TIMESTAMP(), own_range_start, range_start - own_range_start);
+	}
+	if (cancelled) {
+		return processed_items + skip_job_items(job);
+	}
+	if (has_new_command(threadpool, command)) {
+		return processed_items;
+	}
+
+	/* Done, now look for other threads' items to steal, starting from the nearest neighbour on the same NUMA node */
+	const size_t threads_count = job->threads_count;
+	const size_t numa_group_start = thread->numa_group_start;
+	const size_t numa_group_end = min(thread->numa_group_end, threads_count);
+	for (size_t tid = next_thread_in_group(thread_number, numa_group_start, numa_group_end);
+		tid != thread_number;
+		tid = next_thread_in_group(tid, numa_group_start, numa_group_end))
+	{
+		if (!steal_items_1d(threadpool, command, thread, segments, tid, function, argument, pass_thread,
+			cancellable, cancellation, grain, guided, &processed_items))
+		{
+			return leave_stolen_items(job, cancellation, processed_items);
+		}
+	}
+
+	/* Then steal from the threads on other NUMA nodes */
+	for (size_t tid = numa_group_end % threads_count; tid != numa_group_start; tid = (tid + 1) % threads_count) {
+		if (!steal_items_1d(threadpool, command, thread, segments, tid, function, argument, pass_thread,
+			cancellable, cancellation, grain, guided, &processed_items))
+		{
+			return leave_stolen_items(job, cancellation, processed_items);
+		}
+	}
+
+	/* All items are taken: threads which look for work need not join this job anymore */
+	__atomic_store_n(&job->exhausted, 1, __ATOMIC_RELAXED);
+	return processed_items;
+}
+
+static size_t thread_compute_1d(struct pthreadpool* threadpool, struct job* job, struct thread_info* thread) {
+	return thread_compute_1d_generic(threadpool, job, thread, false, false);
+}
+
+static size_t thread_compute_1d_with_thread(struct pthreadpool* threadpool, struct job* job, struct thread_info* thread) {
+	return thread_compute_1d_generic(threadpool, job, thread, true, false);
+}
+
+static size_t thread_compute_1d_cancellable(struct pthreadpool* threadpool, struct job* job, struct thread_info* thread) {
+	return thread_compute_1d_generic(threadpool, job, thread, false, true);
+}
+
+/*
+ * Moves an idle worker thread, which is registered as a waiter for a new command, to hibernation until a command
+ * wakes up hibernating worker threads. Returns the new command.
+ */
+static uint32_t hibernate_worker_thread(
+	struct pthreadpool* threadpool,
+	struct thread_info* thread,
+	uint32_t last_command)
+{
+	/*
+	 * The thread registers as hibernating before it unregisters as a waiter, so that wake_idle_worker_threads counts
+	 * it either way. Sequentially consistent ordering pairs with the submission of commands in wakeup_worker_threads:
+	 * either the thread observes the new command, or the submitting thread observes the hibernating thread.
+	 */
+	__atomic_add_fetch(&threadpool->hibernating_threads, 1, __ATOMIC_SEQ_CST);
+	__atomic_sub_fetch(&threadpool->command_waiters, 1, __ATOMIC_SEQ_CST);
+	PTHREADPOOL_STATS_ADD(thread, hibernations, 1);
+	const uint32_t hibernation_events = __atomic_load_n(&threadpool->hibernation_events, __ATOMIC_SEQ_CST);
+	uint32_t command = __atomic_load_n(&threadpool->command, __ATOMIC_SEQ_CST);
+	if (command == last_command) {
+		/* Commands which the other worker threads can handle change the command, but leave the thread asleep */
+		while (__atomic_load_n(&threadpool->hibernation_events, __ATOMIC_SEQ_CST) == hibernation_events) {
+			pthreadpool_futex_wait(&threadpool->hibernation_events, hibernation_events);
+		}
+		/* Wake-ups of hibernating threads follow the submission of a command */
+		command = __atomic_load_n(&threadpool->command, __ATOMIC_ACQUIRE);
+	}
+	__atomic_sub_fetch(&threadpool->hibernating_threads, 1, __ATOMIC_RELAXED);
+	return command;
+}
+
+static uint32_t wait_for_new_command(
+	struct pthreadpool* threadpool,
+	struct thread_info* thread,
+	uint32_t last_command)
+{
+	uint32_t command = __atomic_load_n(&threadpool->command, __ATOMIC_ACQUIRE);
+	if (command != last_command) {
+		return command;
+	}
+
+	/* Spin-wait for a while: back-to-back commands are then picked up without a futex round-trip */
+	const uint32_t spin_wait_iterations = __atomic_load_n(&threadpool->spin_wait_iterations, __ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < spin_wait_iterations; i++) {
+		pthreadpool_spin_wait_hint();
+		command = __atomic_load_n(&threadpool->command, __ATOMIC_ACQUIRE);
+		if (command != last_command) {
+			PTHREADPOOL_STATS_ADD(thread, spin_iterations, i + 1);
+			return command;
+		}
+	}
+	PTHREADPOOL_STATS_ADD(thread, spin_iterations, spin_wait_iterations);
+
+	/* No new command: register as a waiter and fall back to sleeping on a futex */
+	uint64_t hibernation_delay_ns = __atomic_load_n(&threadpool->hibernation_delay_ns, __ATOMIC_RELAXED);
+	if (thread->thread_number - threadpool->workers_start < __atomic_load_n(&threadpool->warm_threads_count, __ATOMIC_RELAXED)) {
+		hibernation_delay_ns = UINT64_MAX;
+	}
+	const uint64_t sleep_start = hibernation_delay_ns != UINT64_MAX ? pthreadpool_get_time_ns() : 0;
+	__atomic_add_fetch(&threadpool->command_waiters, 1, __ATOMIC_SEQ_CST);
+	while ((command = __atomic_load_n(&threadpool->command, __ATOMIC_SEQ_CST)) == last_command) {
+		PTHREADPOOL_STATS_ADD(thread, futex_waits, 1);
+		if (hibernation_delay_ns == UINT64_MAX) {
+			pthreadpool_futex_wait(&threadpool->command, last_command);
+		} else {
+			const uint64_t sleep_ns = pthreadpool_get_time_ns() - sleep_start;
+			if (sleep_ns >= hibernation_delay_ns) {
+				return hibernate_worker_thread(threadpool, thread, last_command);
+			}
+			pthreadpool_futex_wait_timeout(&threadpool->command, last_command, hibernation_delay_ns - sleep_ns);
+		}
+	}
+	__atomic_sub_fetch(&threadpool->command_waiters, 1, __ATOMIC_RELAXED);
+	return command;
+}
+
+/* Returns the command word for a new command, which differs from the last command in the counter bits */
+static inline uint32_t make_new_command(struct pthreadpool* threadpool, enum threadpool_command command) {
+	const uint32_t last_command = __atomic_load_n(&threadpool->command, __ATOMIC_RELAXED);
+	return ((last_command & ~THREADPOOL_COMMAND_MASK) + THREADPOOL_COMMAND_MASK + 1) | (uint32_t) command;
+}
+
+/* Checks if the job with the specified handle completed, accounting for wrap-around */
+static inline bool is_job_completed(uint32_t completed_handle, uint32_t handle) {
+	return (int32_t) (completed_handle - handle) >= 0;
+}
+
+/* Returns the slot of the job with the specified handle */
+static inline struct job* get_job_slot(struct pthreadpool* threadpool, uint32_t handle) {
+	return &threadpool->jobs[handle % PTHREADPOOL_JOB_QUEUE_SIZE];
+}
+
+/* Wakes up the threads waiting for job completions and job slot releases, if there are any */
+static void signal_job_event(struct pthreadpool* threadpool) {
+	/*
+	 * Sequentially consistent ordering pairs with the registration of waiters in wait_for_job_event:
+	 * either a waiter observes the event, or we observe the waiter and wake it up.
+	 */
+	if (__atomic_load_n(&threadpool->job_waiters, __ATOMIC_SEQ_CST) != 0) {
+		__atomic_add_fetch(&threadpool->job_events, 1, __ATOMIC_SEQ_CST);
+		pthreadpool_futex_wake_all(&threadpool->job_events);
+	}
+}
+
+/*
+ * Waits until the predicate holds. The predicate may only become true after a job completes or a job slot is released:
+ * signal_job_event follows such updates and wakes up the waiter.
+ */
+static void wait_for_job_event(
+	struct pthreadpool* threadpool,
+	bool (*predicate)(struct pthreadpool*, uint32_t),
+	uint32_t argument)
+{
+	/* Spin-wait for a while: if the job completes soon, this avoids a futex round-trip on both sides */
+	const uint32_t spin_wait_iterations = __atomic_load_n(&threadpool->spin_wait_iterations, __ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < spin_wait_iterations; i++) {
+		if (predicate(threadpool, argument)) {
+			return;
+		}
+		pthreadpool_spin_wait_hint();
+	}
+
+	/* The jobs are still running: register as a waiter and fall back to sleeping on a futex */
+	__atomic_add_fetch(&threadpool->job_waiters, 1, __ATOMIC_SEQ_CST);
+	for (;;) {
+		const uint32_t job_events = __atomic_load_n(&threadpool->job_events, __ATOMIC_SEQ_CST);
+		if (predicate(threadpool, argument)) {
+			break;
+		}
+		pthreadpool_futex_wait(&threadpool->job_events, job_events);
+	}
+	__atomic_sub_fetch(&threadpool->job_waiters, 1, __ATOMIC_RELAXED);
+}
+
+/* Predicate for wait_for_job_event: the job with the specified handle completed */
+static bool is_job_handle_completed(struct pthreadpool* threadpool, uint32_t handle) {
+	return is_job_completed(__atomic_load_n(&get_job_slot(threadpool, handle)->completed_handle, __ATOMIC_SEQ_CST), handle);
+}
+
+/* Waits until the job with the specified handle completes */
+static void wait_for_job(struct pthreadpool* threadpool, uint32_t handle) {
+	wait_for_job_event(threadpool, is_job_handle_completed, handle);
+}
+
+/* Checks if the job slot can be reused: its last job completed, and no thread accesses the slot */
+static bool is_job_slot_free(struct job* job) {
+	/*
+	 * Sequentially consistent ordering pairs with the registration of a user in join_job:
+	 * either the joining thread observes the completed job, or we observe the user.
+	 */
+	return __atomic_load_n(&job->completed_handle, __ATOMIC_SEQ_CST) == __atomic_load_n(&job->submitted_handle, __ATOMIC_RELAXED) &&
+		__atomic_load_n(&job->users, __ATOMIC_SEQ_CST) == 0;
+}
+
+/*
+ * Returns a free job slot for a job of the specified priority, or NULL if there is none.
+ * Normal-priority jobs leave the last PTHREADPOOL_HIGH_PRIORITY_JOB_SLOTS free slots to high-priority jobs.
+ */
+static struct job* find_free_job_slot(struct pthreadpool* threadpool, bool high_priority) {
+	struct job* free_job = NULL;
+	size_t free_slots_count = 0;
+	for (size_t i = 0; i < PTHREADPOOL_JOB_QUEUE_SIZE; i++) {
+		struct job* job = &threadpool->jobs[i];
+		if (is_job_slot_free(job)) {
+			if (high_priority) {
+				return job;
+			}
+			free_job = job;
+			if (++free_slots_count > PTHREADPOOL_HIGH_PRIORITY_JOB_SLOTS) {
+				return free_job;
+			}
+		}
+	}
+	return NULL;
+}
+
+/* Predicate for wait_for_job_event: some job slot is free for a job of the specified priority */
+static bool has_free_job_slot(struct pthreadpool* threadpool, uint32_t high_priority) {
+	return find_free_job_slot(threadpool, high_priority != 0) != NULL;
+}
+
+/* Predicate for wait_for_job_event: all job slots are free */
+static bool are_job_slots_free(struct pthreadpool* threadpool, uint32_t unused) {
+	for (size_t i = 0; i < PTHREADPOOL_JOB_QUEUE_SIZE; i++) {
+		if (!is_job_slot_free(&threadpool->jobs[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Unregisters the thread as a user of the job slot */
+static void release_job_slot(struct pthreadpool* threadpool, struct job* job) {
+	if (__atomic_sub_fetch(&job->users, 1, __ATOMIC_SEQ_CST) == 0) {
+		signal_job_event(threadpool);
+	}
+}
+
+/*
+ * Registers the thread as a user of the job slot if the slot still runs the job with the specified handle, and
+ * the job has items left. Returns true if the thread joined the job, and must leave it with leave_job.
+ */
+static bool join_job(struct pthreadpool* threadpool, struct job* job, uint32_t handle) {
+	__atomic_add_fetch(&job->users, 1, __ATOMIC_SEQ_CST);
+	/* The acquire half of the load pairs with the release of job parameters in submit_job */
+	if (__atomic_load_n(&job->submitted_handle, __ATOMIC_SEQ_CST) == handle &&
+		__atomic_load_n(&job->completed_handle, __ATOMIC_SEQ_CST) != handle &&
+		__atomic_load_n(&job->exhausted, __ATOMIC_RELAXED) == 0)
+	{
+		return true;
+	}
+	release_job_slot(threadpool, job);
+	return false;
+}
+
+/* Accounts for the items processed by the thread, completes the job if they were the last ones, and leaves the job */
+static void leave_job(struct pthreadpool* threadpool, struct job* job, size_t processed_items) {
+	if (processed_items != 0 && __atomic_sub_fetch(&job->remaining_items, processed_items, __ATOMIC_ACQ_REL) == 0) {
+		/* The release half publishes the results of the job to the threads which wait for its completion */
+		__atomic_store_n(&job->completed_handle, __atomic_load_n(&job->submitted_handle, __ATOMIC_RELAXED), __ATOMIC_SEQ_CST);
+		signal_job_event(threadpool);
+	}
+	release_job_slot(threadpool, job);
+}
+
+/*
+ * Joins one of the specified running jobs. Threads with different numbers prefer different jobs,
+ * so that worker threads spread evenly across the running jobs. Returns NULL if the thread joined none of them.
+ */
+static struct job* join_any_job(
+	struct pthreadpool* threadpool,
+	struct thread_info* thread,
+	struct job* running_jobs[],
+	const uint32_t running_handles[],
+	size_t running_jobs_count)
+{
+	for (size_t i = 0; i < running_jobs_count; i++) {
+		const size_t j = (thread->thread_number + i) % running_jobs_count;
+		if (join_job(threadpool, running_jobs[j], running_handles[j])) {
+			/* The job parameters might have been stale before joining the job */
+			if (__atomic_load_n(&running_jobs[j]->threads_count, __ATOMIC_RELAXED) > thread->thread_number) {
+				return running_jobs[j];
+			}
+			leave_job(threadpool, running_jobs[j], 0);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Joins one of the running jobs which have items left, preferring high-priority jobs to normal-priority ones.
+ * Returns NULL if there are no such jobs.
+ */
+static struct job* join_running_job(struct pthreadpool* threadpool, struct thread_info* thread) {
+	/* High-priority jobs fill the arrays from the start, and normal-priority jobs from the end */
+	struct job* running_jobs[PTHREADPOOL_JOB_QUEUE_SIZE];
+	uint32_t running_handles[PTHREADPOOL_JOB_QUEUE_SIZE];
+	size_t high_priority_jobs_count = 0;
+	size_t normal_priority_jobs_start = PTHREADPOOL_JOB_QUEUE_SIZE;
+	for (size_t i = 0; i < PTHREADPOOL_JOB_QUEUE_SIZE; i++) {
+		struct job* job = &threadpool->jobs[i];
+		const uint32_t handle = __atomic_load_n(&job->submitted_handle, __ATOMIC_RELAXED);
+		if (__atomic_load_n(&job->completed_handle, __ATOMIC_RELAXED) != handle &&
+			__atomic_load_n(&job->exhausted, __ATOMIC_RELAXED) == 0 &&
+			__atomic_load_n(&job->threads_count, __ATOMIC_RELAXED) > thread->thread_number)
+		{
+			const size_t position = __atomic_load_n(&job->high_priority, __ATOMIC_RELAXED) != 0 ?
+				high_priority_jobs_count++ : --normal_priority_jobs_start;
+			running_jobs[position] = job;
+			running_handles[position] = handle;
+		}
+	}
+
+	struct job* job = join_any_job(threadpool, thread, running_jobs, running_handles, high_priority_jobs_count);
+	if (job == NULL) {
+		/* No high-priority job has items left for this thread */
+		job = join_any_job(threadpool, thread, &running_jobs[normal_priority_jobs_start],
+			&running_handles[normal_priority_jobs_start], PTHREADPOOL_JOB_QUEUE_SIZE - normal_priority_jobs_start);
+	}
+	return job;
+}
+
+/* Processes items of the running jobs on a worker thread until all items are taken */
+static void process_jobs(struct pthreadpool* threadpool, struct thread_info* thread) {
+	struct job* job;
+	while ((job = join_running_job(threadpool, thread)) != NULL) {
+		const uint64_t job_start = PTHREADPOOL_TRACE_TIMESTAMP();
+		const size_t processed_items = job->thread_function(threadpool, job, thread);
+		PTHREADPOOL_TRACE_EVENT(thread, trace_event_job, __atomic_load_n(&job->submitted_handle, __ATOMIC_RELAXED),
+			job_start, PTHREADPOOL_TRACE_TIMESTAMP(), 0, processed_items);
+		leave_job(threadpool, job, processed_items);
+	}
+}
+
+/* Processes items of the job with the specified handle on the calling thread, which acts as thread 0 */
+static void participate_in_job(struct pthreadpool* threadpool, uint32_t handle) {
+	struct job* job = get_job_slot(threadpool, handle);
+	if (join_job(threadpool, job, handle)) {
+		pthreadpool_set_current_threadpool(threadpool);
+		struct thread_info* thread = &threadpool->threads[0];
+		const uint64_t busy_start = PTHREADPOOL_STATS_TIMESTAMP();
+		const uint64_t job_start = PTHREADPOOL_TRACE_TIMESTAMP();
+		size_t processed_items = 0;
+		do {
+			processed_items += job->thread_function(threadpool, job, thread);
+		} while (__atomic_load_n(&job->exhausted, __ATOMIC_RELAXED) == 0);
+		PTHREADPOOL_TRACE_EVENT(thread, trace_event_job, handle, job_start, PTHREADPOOL_TRACE_TIMESTAMP(), 0, processed_items);
+		PTHREADPOOL_STATS_ADD(thread, busy_ns, PTHREADPOOL_STATS_TIMESTAMP() - busy_start);
+		pthreadpool_set_current_threadpool(NULL);
+		leave_job(threadpool, job, processed_items);
+	}
+}
+
+/*
+ * Returns the start of the initial segment of the thread in a job of range items, where threads with numbers
+ * in the [participants_start, threads_count) range split the items evenly, and other threads get empty segments.
+ * The segment of the thread ends at the start of the segment of the next thread.
+ */
+static inline size_t get_segment_start(size_t range, size_t tid, size_t participants_start, size_t threads_count) {
+	if (tid <= participants_start) {
+		return 0;
+	}
+	return multiply_divide(range, tid - participants_start, threads_count - participants_start);
+}
+
+/*
+ * Submits a job to a free job slot, blocking while all slots are busy, and wakes up the worker threads.
+ * If context_size is non-zero, the argument is copied into the job, and must fit into PTHREADPOOL_JOB_CONTEXT_SIZE.
+ * The job is processed by threads with numbers below threads_count, which claim up to grain items per atomic update,
+ * or half of the remaining items of a segment if guided is true and this is more. Worker threads prefer jobs with
+ * high_priority set to other jobs. If cancellation is not NULL, setting it to non-zero cancels the job.
+ * If with_caller is true, the items are spread
+ * over all of them, and the calling thread must participate in the job as thread 0; otherwise, only over the worker
+ * threads. If partition is not NULL, it holds the initial segments for these threads_count and with_caller.
+ * Wakes up sleeping worker threads for up to wakeup_threads_count worker threads to look for the job.
+ * Returns the completion handle for the job.
+ */
+static uint32_t submit_job(
+	struct pthreadpool* threadpool,
+	thread_function_t thread_function,
+	void* function,
+	void* argument,
+	size_t context_size,
+	size_t range,
+	size_t grain,
+	bool guided,
+	bool high_priority,
+	uint32_t* cancellation,
+	size_t threads_count,
+	bool with_caller,
+	const struct job_partition* partition,
+	size_t wakeup_threads_count)
+{
+	pthreadpool_mutex_lock(&threadpool->execution_mutex);
+
+	/* Only threads holding the execution mutex take free job slots */
+	struct job* job;
+	while ((job = find_free_job_slot(threadpool, high_priority)) == NULL) {
+		wait_for_job_event(threadpool, has_free_job_slot, (uint32_t) high_priority);
+	}
+
+	/* Locking not needed: other threads do not touch the job parameters until they observe the new handle */
+	job->thread_function = thread_function;
+	job->function = function;
+	job->argument = argument;
+	job->grain = grain;
+	job->guided = (uint32_t) guided;
+	__atomic_store_n(&job->high_priority, (uint32_t) high_priority, __ATOMIC_RELAXED);
+	__atomic_store_n(&job->cancelled, 0, __ATOMIC_RELAXED);
+	job->cancellation = cancellation != NULL ? cancellation : &job->cancelled;
+	if (context_size != 0) {
+		memcpy(job->context, argument, context_size);
+		job->argument = job->context;
+	}
+
+	/* Spread the work between the participating threads; other threads get empty segments */
+	__atomic_store_n(&job->threads_count, threads_count, __ATOMIC_RELAXED);
+	const size_t participants_start = with_caller ? 0 : threadpool->workers_start;
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		struct job_segment* segment = &job->segments[tid];
+		size_t range_start, range_end;
+		if (partition != NULL) {
+			range_start = partition->boundaries[tid];
+			range_end = partition->boundaries[tid + 1];
+		} else {
+			range_start = get_segment_start(range, tid, participants_start, threads_count);
+			range_end = get_segment_start(range, tid + 1, participants_start, threads_count);
+		}
+		__atomic_store_n(&segment->range_start, range_start, __ATOMIC_RELAXED);
+		__atomic_store_n(&segment->range_end, range_end, __ATOMIC_RELAXED);
+		__atomic_store_n(&segment->range_length, range_end - range_start, __ATOMIC_RELAXED);
+	}
+	__atomic_store_n(&job->remaining_items, range, __ATOMIC_RELAXED);
+	__atomic_store_n(&job->exhausted, 0, __ATOMIC_RELAXED);
+
+	/* Handle 0 never identifies a job: it denotes a job which is already complete */
+	uint32_t handle = job->submitted_handle + PTHREADPOOL_JOB_QUEUE_SIZE;
+	if (handle == 0) {
+		handle = PTHREADPOOL_JOB_QUEUE_SIZE;
+	}
+	/* The release half of the store publishes the job parameters */
+	__atomic_store_n(&job->submitted_handle, handle, __ATOMIC_SEQ_CST);
+
+	/* Update the threadpool command to make idle worker threads look for the new job, and busy ones rebalance */
+	wakeup_worker_threads(threadpool, make_new_command(threadpool, threadpool_command_compute_1d), wakeup_threads_count);
+
+	pthreadpool_mutex_unlock(&threadpool->execution_mutex);
+	return handle;
+}
+
+/* Per-call options of a job, which are not a part of the adapter context */
+struct job_options {
+	/* The maximum number of threads to process the job */
+	size_t max_threads_count;
+	/*
+	 * The number of items which threads claim at once, or 0 to derive it from the range and the number of threads.
+	 * With the guided schedule, the minimum number of items.
+	 */
+	size_t grain;
+	/* PTHREADPOOL_FLAG_SCHEDULE_* and PTHREADPOOL_FLAG_PRIORITY_HIGH flags */
+	uint32_t flags;
+	/* Precomputed initial segments of the threads, or NULL. Ignored if computed for another number of threads. */
+	const struct job_partition* partition;
+	/* The flag which cancels the job when set to non-zero, or NULL to cancel the job with pthreadpool_cancel */
+	uint32_t* cancellation;
+	/* The number of threads which the job can keep busy, or 0 to derive it from the range and the grain */
+	size_t parallelism;
+};
+
+static const struct job_options default_job_options = {
+	.max_threads_count = SIZE_MAX,
+	.grain = 1,
+	.flags = 0,
+	.partition = NULL,
+	.cancellation = NULL,
+	.parallelism = 0,
+};
+
+/*
+ * Starts the worker threads with thread numbers below threads_end which are not running yet, and waits until they
+ * initialize. Returns false if a thread failed to start: the threads before it keep running.
+ * Must be called under the execution mutex, or before the thread pool is shared with other threads.
+ */
+static bool start_worker_threads(struct pthreadpool* threadpool, size_t threads_end) {
+	const size_t threads_start = threadpool->started_threads_end;
+	if (threads_start >= threads_end) {
+		return true;
+	}
+	threadpool->has_active_threads = 1;
+	threadpool->active_threads = threads_end - threads_start;
+
+	size_t tid = threads_start;
+	for (; tid < threads_end; tid++) {
+		if (!pthreadpool_start_thread(&threadpool->threads[tid])) {
+			/* Discount the threads which failed to start */
+			if (__atomic_sub_fetch(&threadpool->active_threads, threads_end - tid, __ATOMIC_ACQ_REL) == 0) {
+				__atomic_store_n(&threadpool->has_active_threads, 0, __ATOMIC_RELEASE);
+			}
+			break;
+		}
+	}
+
+	/* Wait until the started threads initialize */
+	wait_worker_threads(threadpool);
+	__atomic_store_n(&threadpool->started_threads_end, tid, __ATOMIC_RELAXED);
+	return tid == threads_end;
+}
+
+/*
+ * Submits a job with the specified options, and returns its completion handle. The calling thread processes the job as thread 0 if the job is synchronous (unless the thread pool has dedicated
+ * workers), or if the job can't use any worker threads. For a synchronous job, also waits until the job completes.
+ * The argument must outlive the job, or be copied into it.
+ */
+static uint32_t run_job(
+	struct pthreadpool* threadpool,
+	thread_function_t thread_function,
+	void* function,
+	void* argument,
+	size_t context_size,
+	size_t range,
+	const struct job_options* options,
+	bool synchronous)
+{
+	if (range == 0) {
+		return 0;
+	}
+	const size_t threads_count = min(get_enabled_threads_count(threadpool), options->max_threads_count);
+	const bool has_workers = threadpool->workers_start < threads_count;
+	bool with_caller = has_workers ? synchronous && threadpool->workers_start != 0 : true;
+	size_t grain = options->grain;
+	const uint32_t schedule = options->flags & PTHREADPOOL_FLAG_SCHEDULE_MASK;
+	if (schedule == PTHREADPOOL_FLAG_SCHEDULE_STATIC) {
+		/*
+		 * Threads claim their whole initial segments at once. Segments of threads which do not join the job
+		 * (e.g. busy with other jobs) are still claimed whole by other threads.
+		 */
+		grain = SIZE_MAX;
+	} else if (grain == 0) {
+		/* Few batches per thread amortize the atomic updates, while enough remain to balance the load by stealing */
+		grain = range / (threads_count * PTHREADPOOL_AUTO_GRAIN_BATCHES_PER_THREAD);
+		if (grain == 0) {
+			grain = 1;
+		}
+	}
+	const struct job_partition* partition = options->partition;
+	if (partition != NULL && partition->threads_count != threads_count) {
+		/* The number of enabled threads changed after the partition was computed */
+		partition = NULL;
+	}
+	/*
+	 * Jobs of few items wake up only the worker threads they can keep busy. Other worker threads, e.g. parked ones,
+	 * may not process the job, and then all worker threads are woken up.
+	 */
+	size_t wakeup_threads_count = SIZE_MAX;
+	if (threads_count == threadpool->threads_count) {
+		size_t parallelism = options->parallelism;
+		if (parallelism == 0) {
+			parallelism = grain == SIZE_MAX ? range : divide_round_up(range, grain);
+		}
+		wakeup_threads_count = min(parallelism, threads_count - (with_caller ? 0 : threadpool->workers_start)) - (size_t) with_caller;
+	}
+	/* Lazily started worker threads start when the first job which can keep them busy runs */
+	const size_t workers_end = threadpool->workers_start + min(wakeup_threads_count, threads_count - threadpool->workers_start);
+	if (has_workers && __atomic_load_n(&threadpool->started_threads_end, __ATOMIC_RELAXED) < workers_end) {
+		pthreadpool_mutex_lock(&threadpool->execution_mutex);
+		start_worker_threads(threadpool, workers_end);
+		pthreadpool_mutex_unlock(&threadpool->execution_mutex);
+		if (__atomic_load_n(&threadpool->started_threads_end, __ATOMIC_RELAXED) == threadpool->workers_start) {
+			/* No worker thread could start: the calling thread processes the job */
+			with_caller = true;
+		}
+	}
+	const uint32_t handle = submit_job(threadpool, thread_function, function, argument, context_size, range, grain,
+		schedule == PTHREADPOOL_FLAG_SCHEDULE_GUIDED, (options->flags & PTHREADPOOL_FLAG_PRIORITY_HIGH) != 0,
+		options->cancellation, threads_count, with_caller, partition, wakeup_threads_count);
+	if (with_caller) {
+		participate_in_job(threadpool, handle);
+	}
+	if (synchronous) {
+		wait_for_job(threadpool, handle);
+	}
+	return handle;
+}
+
+/* Blocks a worker thread while its thread number is not below the number of enabled threads */
+static void park_worker_thread(struct pthreadpool* threadpool, struct thread_info* thread) {
+	uint32_t enabled_threads_count = __atomic_load_n(&threadpool->enabled_threads_count, __ATOMIC_ACQUIRE);
+	if (enabled_threads_count <= thread->thread_number) {
+		/* The thread might have been woken up for a job submitted before the number of threads shrank: pass it on */
+		wake_idle_worker_threads(threadpool, SIZE_MAX);
+		do {
+			pthreadpool_futex_wait(&threadpool->enabled_threads_count, enabled_threads_count);
+		} while ((enabled_threads_count = __atomic_load_n(&threadpool->enabled_threads_count, __ATOMIC_ACQUIRE)) <= thread->thread_number);
+	}
+}
+
+/* Changes the number of enabled threads, and wakes up the parked worker threads if it grows */
+static void enable_threads(struct pthreadpool* threadpool, size_t threads_count) {
+	const uint32_t last_threads_count =
+		__atomic_exchange_n(&threadpool->enabled_threads_count, (uint32_t) threads_count, __ATOMIC_ACQ_REL);
+	if (threads_count > last_threads_count) {
+		pthreadpool_futex_wake_all(&threadpool->enabled_threads_count);
+	}
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_thread_main(struct thread_info* thread) {
+	struct pthreadpool* threadpool = ((struct pthreadpool*) (thread - thread->thread_number)) - 1;
+	uint32_t last_command = threadpool_command_init;
+
+	if (thread->processor != PTHREADPOOL_NO_PROCESSOR) {
+		pthreadpool_bind_current_thread(thread->processor);
+	}
+	/* Worker threads call item processing functions only, and run the calls they make sequentially */
+	pthreadpool_set_current_threadpool(threadpool);
+
+	/* Check in */
+	checkin_worker_thread(threadpool);
+
+	/* Monitor new commands and act accordingly */
+	for (;;) {
+		const uint64_t idle_start = PTHREADPOOL_STATS_TIMESTAMP();
+		const uint32_t command = wait_for_new_command(threadpool, thread, last_command);
+
+		/* Process command */
+		switch (command & THREADPOOL_COMMAND_MASK) {
+			case threadpool_command_compute_1d:
+			{
+				park_worker_thread(threadpool, thread);
+				const uint64_t busy_start = PTHREADPOOL_STATS_TIMESTAMP();
+				PTHREADPOOL_STATS_ADD(thread, idle_ns, busy_start - idle_start);
+				process_jobs(threadpool, thread);
+				PTHREADPOOL_STATS_ADD(thread, busy_ns, PTHREADPOOL_STATS_TIMESTAMP() - busy_start);
+				break;
+			}
+			case threadpool_command_shutdown:
+				pthreadpool_set_current_threadpool(NULL);
+				/*
+				 * Notify the master thread that we are exiting. Unlike checkin_worker_thread, wake up the master thread
+				 * unconditionally: it may release the thread pool as soon as has_active_threads is reset, so the thread
+				 * pool must not be accessed after that.
+				 */
+				if (__atomic_sub_fetch(&threadpool->active_threads, 1, __ATOMIC_ACQ_REL) == 0) {
+					__atomic_store_n(&threadpool->has_active_threads, 0, __ATOMIC_RELEASE);
+					pthreadpool_futex_wake_all(&threadpool->has_active_threads);
+				}
+				return;
+			case threadpool_command_init:
+				/* To inhibit compiler warning */
+				break;
+		}
+		/* Update last command */
+		last_command = command;
+	};
+}
+
+/* Shuts down the worker threads with thread numbers in the [workers_start, workers_end) range */
+static void shutdown_worker_threads(struct pthreadpool* threadpool, size_t workers_end) {
+	/* Wait for any threads which are still initializing */
+	wait_worker_threads(threadpool);
+
+	const size_t workers_start = threadpool->workers_start;
+	threadpool->active_threads = workers_end - workers_start;
+	threadpool->has_active_threads = 1;
+	wakeup_worker_threads(threadpool, make_new_command(threadpool, threadpool_command_shutdown), SIZE_MAX);
+
+	/* Wait until all threads acknowledge the shutdown command */
+	wait_worker_threads(threadpool);
+
+	/* Wait until all threads return */
+	for (size_t tid = workers_start; tid < workers_end; tid++) {
+		pthreadpool_join_thread(&threadpool->threads[tid]);
+	}
+}
+
+/*
+ * Selects the processors to bind threads to according to the affinity policy.
+ * Returns the number of processors stored in the selected_processors array, which must have room for
+ * max(pthreadpool_get_processors_count(), attributes->cpus_count) elements, or 0 if threads are not to be bound.
+ */
+static size_t select_processors(
+	const struct pthreadpool_attributes* attributes,
+	struct pthreadpool_processor* available_processors,
+	size_t available_processors_count,
+	struct pthreadpool_processor* selected_processors)
+{
+	size_t selected_processors_count = 0;
+	switch (attributes->affinity) {
+		case pthreadpool_affinity_none:
+			break;
+		case pthreadpool_affinity_cpus:
+			for (size_t i = 0; i < attributes->cpus_count; i++) {
+				/* Processors not available to the process are kept in the list, but left unbound */
+				struct pthreadpool_processor processor = {
+					.id = PTHREADPOOL_NO_PROCESSOR,
+					.core = attributes->cpus[i],
+					.node = 0,
+				};
+				for (size_t j = 0; j < available_processors_count; j++) {
+					if (available_processors[j].id == attributes->cpus[i]) {
+						processor = available_processors[j];
+						break;
+					}
+				}
+				selected_processors[selected_processors_count++] = processor;
+			}
+			break;
+		case pthreadpool_affinity_physical_cores:
+			for (size_t i = 0; i < available_processors_count; i++) {
+				bool is_smt_sibling = false;
+				for (size_t j = 0; j < selected_processors_count; j++) {
+					if (selected_processors[j].core == available_processors[i].core) {
+						is_smt_sibling = true;
+						break;
+					}
+				}
+				if (!is_smt_sibling) {
+					selected_processors[selected_processors_count++] = available_processors[i];
+				}
+			}
+			break;
+	}
+	return selected_processors_count;
+}
+
+/*
+ * Binds threads to the selected processors round-robin, and numbers the threads so that
+ * the threads on the same NUMA node are consecutive. The order of the threads within a node is preserved.
+ * The thread_processors array is used as temporary storage and must have room for threads_count elements.
+ */
+static void assign_processors(
+	struct pthreadpool* threadpool,
+	const struct pthreadpool_processor* selected_processors,
+	size_t selected_processors_count,
+	struct pthreadpool_processor* thread_processors)
+{
+	const size_t threads_count = threadpool->threads_count;
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		/* Insertion sort by NUMA node: stable, and fast for the typical case of processors already ordered by node */
+		const struct pthreadpool_processor processor = selected_processors[tid % selected_processors_count];
+		size_t position = tid;
+		while (position != 0 && thread_processors[position - 1].node > processor.node) {
+			thread_processors[position] = thread_processors[position - 1];
+			position--;
+		}
+		thread_processors[position] = processor;
+	}
+
+	size_t numa_group_start = 0;
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		if (thread_processors[tid].node != thread_processors[numa_group_start].node) {
+			numa_group_start = tid;
+		}
+		threadpool->threads[tid].processor = thread_processors[tid].id;
+		threadpool->threads[tid].numa_group_start = numa_group_start;
+	}
+	size_t numa_group_end = threads_count;
+	for (size_t tid = threads_count; tid != 0; tid--) {
+		threadpool->threads[tid - 1].numa_group_end = numa_group_end;
+		if (threadpool->threads[tid - 1].numa_group_start == tid - 1) {
+			numa_group_end = tid - 1;
+		}
+	}
+}
+
+struct pthreadpool* pthreadpool_create(size_t threads_count) {
+	const struct pthreadpool_attributes attributes = {
+		.threads_count = threads_count,
+	};
+	return pthreadpool_create_with_attributes(&attributes);
+}
+
+struct pthreadpool* pthreadpool_create_with_attributes(const struct pthreadpool_attributes* attributes) {
+	static const struct pthreadpool_attributes default_attributes = { 0 };
+	if (attributes == NULL) {
+		attributes = &default_attributes;
+	}
+	if (attributes->affinity == pthreadpool_affinity_cpus && (attributes->cpus == NULL || attributes->cpus_count == 0)) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (is_nested_call()) {
+		/* Threads of another thread pool would oversubscribe the processors: nested calls run sequentially instead */
+		errno = EPERM;
+		return NULL;
+	}
+
+	struct pthreadpool* threadpool = NULL;
+	struct pthreadpool_processor* thread_processors = NULL;
+
+	/* Choose the processors to bind threads to */
+	struct pthreadpool_processor* available_processors = NULL;
+	struct pthreadpool_processor* selected_processors = NULL;
+	size_t selected_processors_count = 0;
+	const size_t processors_count = pthreadpool_get_processors_count();
+	if (attributes->affinity != pthreadpool_affinity_none) {
+		const size_t max_selected_processors_count =
+			processors_count > attributes->cpus_count ? processors_count : attributes->cpus_count;
+		available_processors = pthreadpool_allocate(processors_count * sizeof(struct pthreadpool_processor));
+		selected_processors = pthreadpool_allocate(max_selected_processors_count * sizeof(struct pthreadpool_processor));
+		if (available_processors == NULL || selected_processors == NULL) {
+			goto cleanup;
+		}
+		const size_t available_processors_count = pthreadpool_get_processors(available_processors, processors_count);
+		selected_processors_count =
+			select_processors(attributes, available_processors, available_processors_count, selected_processors);
+	}
+
+	size_t threads_count = attributes->threads_count;
+	if (threads_count == 0) {
+		threads_count = selected_processors_count != 0 ? selected_processors_count : processors_count;
+	}
+
+	/* The work segments of all job slots, and the trace event ring buffers, are allocated together with the thread pool */
+	size_t threadpool_size = sizeof(struct pthreadpool) + threads_count * sizeof(struct thread_info) +
+		PTHREADPOOL_JOB_QUEUE_SIZE * threads_count * sizeof(struct job_segment);
+	#if PTHREADPOOL_ENABLE_TRACE
+		threadpool_size += threads_count * PTHREADPOOL_TRACE_EVENTS * sizeof(struct trace_event);
+	#endif
+	threadpool = pthreadpool_allocate(threadpool_size);
+	if (threadpool == NULL) {
+		goto cleanup;
+	}
+	memset(threadpool, 0, threadpool_size);
+	threadpool->threads_count = threads_count;
+	threadpool->enabled_threads_count = (uint32_t) threads_count;
+	/*
+	 * A thread pool with a single thread computes everything on the caller thread, even with dedicated workers.
+	 * Otherwise, unless the pool has dedicated workers, the calling thread acts as thread 0 and has no worker thread.
+	 */
+	threadpool->workers_start = (threads_count > 1 && (attributes->flags & PTHREADPOOL_FLAG_DEDICATED_WORKERS)) ? 0 : 1;
+	struct job_segment* segments = (struct job_segment*) &threadpool->threads[threads_count];
+	for (size_t i = 0; i < PTHREADPOOL_JOB_QUEUE_SIZE; i++) {
+		/* Job handles in the slot are congruent to the slot index modulo PTHREADPOOL_JOB_QUEUE_SIZE */
+		threadpool->jobs[i].submitted_handle = (uint32_t) i;
+		threadpool->jobs[i].completed_handle = (uint32_t) i;
+		threadpool->jobs[i].segments = segments + i * threads_count;
+	}
+	threadpool->spin_wait_iterations = PTHREADPOOL_SPIN_WAIT_ITERATIONS;
+	threadpool->hibernation_delay_ns = UINT64_MAX;
+	threadpool->warm_threads_count = SIZE_MAX;
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		threadpool->threads[tid].thread_number = tid;
+		threadpool->threads[tid].numa_group_start = 0;
+		threadpool->threads[tid].numa_group_end = threads_count;
+		threadpool->threads[tid].processor = PTHREADPOOL_NO_PROCESSOR;
+	}
+	#if PTHREADPOOL_ENABLE_TRACE
+		struct trace_event* trace_events = (struct trace_event*) (segments + PTHREADPOOL_JOB_QUEUE_SIZE * threads_count);
+		for (size_t tid = 0; tid < threads_count; tid++) {
+			threadpool->threads[tid].trace_events = trace_events + tid * PTHREADPOOL_TRACE_EVENTS;
+		}
+		threadpool->trace_start_ns = pthreadpool_get_time_ns();
+	#endif
+	if (selected_processors_count != 0) {
+		thread_processors = pthreadpool_allocate(threads_count * sizeof(struct pthreadpool_processor));
+		if (thread_processors == NULL) {
+			pthreadpool_deallocate(threadpool);
+			threadpool = NULL;
+			goto cleanup;
+		}
+		assign_processors(threadpool, selected_processors, selected_processors_count, thread_processors);
+	}
+
+	pthreadpool_mutex_init(&threadpool->execution_mutex);
+	pthreadpool_mutex_init(&threadpool->scratch_mutex);
+
+	threadpool->started_threads_end = threadpool->workers_start;
+	if (threads_count > 1 && !(attributes->flags & PTHREADPOOL_FLAG_LAZY_WORKERS)) {
+		if (!start_worker_threads(threadpool, threads_count)) {
+			/* Shut down the threads which started before the failure */
+			if (threadpool->started_threads_end != threadpool->workers_start) {
+				shutdown_worker_threads(threadpool, threadpool->started_threads_end);
+			}
+			pthreadpool_mutex_destroy(&threadpool->execution_mutex);
+			pthreadpool_mutex_destroy(&threadpool->scratch_mutex);
+			pthreadpool_deallocate(threadpool);
+			threadpool = NULL;
+			goto cleanup;
+		}
+	}
+
+cleanup:
+	pthreadpool_deallocate(thread_processors);
+	pthreadpool_deallocate(selected_processors);
+	pthreadpool_deallocate(available_processors);
+	return threadpool;
+}
+
+/* The thread pool shared by all callers of pthreadpool_get_default, created by the first call */
+static struct pthreadpool* default_threadpool = NULL;
+
+struct pthreadpool* pthreadpool_get_default(void) {
+	if (is_nested_call()) {
+		/* Nested calls run sequentially on the calling thread anyway */
+		return NULL;
+	}
+	struct pthreadpool* threadpool = __atomic_load_n(&default_threadpool, __ATOMIC_ACQUIRE);
+	if (threadpool == NULL) {
+		/* Worker threads start lazily, so a thread pool which loses the race below is cheap to destroy */
+		const struct pthreadpool_attributes attributes = {
+			.flags = PTHREADPOOL_FLAG_LAZY_WORKERS,
+		};
+		struct pthreadpool* new_threadpool = pthreadpool_create_with_attributes(&attributes);
+		if (new_threadpool == NULL) {
+			return NULL;
+		}
+		if (__atomic_compare_exchange_n(&default_threadpool, &threadpool, new_threadpool, false,
+			__ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+			threadpool = new_threadpool;
+		} else {
+			/* Another thread created the default thread pool concurrently */
+			pthreadpool_destroy(new_threadpool);
+		}
+	}
+	return threadpool;
+}
+
+size_t pthreadpool_get_threads_count(struct pthreadpool* threadpool) {
+	if (threadpool == NULL || is_nested_call()) {
+		return 1;
+	} else {
+		return get_enabled_threads_count(threadpool);
+	}
+}
+
+int pthreadpool_set_threads_count(struct pthreadpool* threadpool, size_t threads_count) {
+	const size_t max_threads_count = threadpool == NULL ? 1 : threadpool->threads_count;
+	if (threads_count == 0 || threads_count > max_threads_count) {
+		return EINVAL;
+	}
+	if (threadpool != NULL) {
+		enable_threads(threadpool, threads_count);
+	}
+	return 0;
+}
+
+void pthreadpool_set_spin_wait_iterations(struct pthreadpool* threadpool, uint32_t iterations) {
+	if (threadpool != NULL) {
+		__atomic_store_n(&threadpool->spin_wait_iterations, iterations, __ATOMIC_RELAXED);
+	}
+}
+
+void pthreadpool_set_idle_policy(
+	struct pthreadpool* threadpool,
+	size_t warm_threads_count,
+	uint64_t hibernation_delay_ns)
+{
+	if (threadpool != NULL) {
+		/* Worker threads which already sleep pick up the new policy after the next command */
+		__atomic_store_n(&threadpool->warm_threads_count, warm_threads_count, __ATOMIC_RELAXED);
+		__atomic_store_n(&threadpool->hibernation_delay_ns, hibernation_delay_ns, __ATOMIC_RELAXED);
+	}
+}
+
+int pthreadpool_get_stats(
+	struct pthreadpool* threadpool,
+	struct pthreadpool_thread_stats* stats,
+	size_t stats_count)
+{
+#if PTHREADPOOL_ENABLE_STATS
+	if (threadpool == NULL) {
+		return EINVAL;
+	}
+	memset(stats, 0, stats_count * sizeof(struct pthreadpool_thread_stats));
+	const size_t threads_count = min(stats_count, threadpool->threads_count);
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		const struct pthreadpool_thread_stats* thread_stats = &threadpool->threads[tid].stats;
+		stats[tid] = (struct pthreadpool_thread_stats) {
+			.items = __atomic_load_n(&thread_stats->items, __ATOMIC_RELAXED),
+			.steals = __atomic_load_n(&thread_stats->steals, __ATOMIC_RELAXED),
+			.failed_steals = __atomic_load_n(&thread_stats->failed_steals, __ATOMIC_RELAXED),
+			.spin_iterations = __atomic_load_n(&thread_stats->spin_iterations, __ATOMIC_RELAXED),
+			.futex_waits = __atomic_load_n(&thread_stats->futex_waits, __ATOMIC_RELAXED),
+			.hibernations = __atomic_load_n(&thread_stats->hibernations, __ATOMIC_RELAXED),
+			.busy_ns = __atomic_load_n(&thread_stats->busy_ns, __ATOMIC_RELAXED),
+			.idle_ns = __atomic_load_n(&thread_stats->idle_ns, __ATOMIC_RELAXED),
+		};
+	}
+	return 0;
+#else
+	return ENOTSUP;
+#endif
+}
+
+#if PTHREADPOOL_ENABLE_TRACE
+/* Text in a caller-provided buffer, which counts the length of the text which does not fit into it */
+struct trace_writer {
+	char* buffer;
+	size_t capacity;
+	size_t length;
+};
+
+static void write_trace(struct trace_writer* writer, const char* format, ...) {
+	char* position = NULL;
+	size_t available = 0;
+	if (writer->length < writer->capacity) {
+		position = writer->buffer + writer->length;
+		available = writer->capacity - writer->length;
+	}
+	va_list arguments;
+	va_start(arguments, format);
+	const int length = vsnprintf(position, available, format, arguments);
+	va_end(arguments);
+	if (length > 0) {
+		writer->length += (size_t) length;
+	}
+}
+
+/* Copies the trace event at the specified position of a thread, or returns false if it is overwritten or incomplete */
+static bool read_trace_event(struct thread_info* thread, uint64_t position, struct trace_event* event) {
+	struct trace_event* record = &thread->trace_events[position % PTHREADPOOL_TRACE_EVENTS];
+	const uint64_t sequence = __atomic_load_n(&record->sequence, __ATOMIC_ACQUIRE);
+	if (sequence != 2 * position + 2) {
+		return false;
+	}
+	event->start_ns = __atomic_load_n(&record->start_ns, __ATOMIC_RELAXED);
+	event->end_ns = __atomic_load_n(&record->end_ns, __ATOMIC_RELAXED);
+	event->range_start = __atomic_load_n(&record->range_start, __ATOMIC_RELAXED);
+	event->range_length = __atomic_load_n(&record->range_length, __ATOMIC_RELAXED);
+	event->type = __atomic_load_n(&record->type, __ATOMIC_RELAXED);
+	event->value = __atomic_load_n(&record->value, __ATOMIC_RELAXED);
+	/* The record is intact if a writer did not start to overwrite it while it was copied */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&record->sequence, __ATOMIC_RELAXED) == sequence;
+}
+
+/* Writes the timestamp relative to the thread pool creation, in microseconds, as Chrome trace format expects */
+static void write_trace_timestamp(struct trace_writer* writer, const char* key, uint64_t timestamp_ns) {
+	write_trace(writer, "\"%s\":%llu.%03llu", key,
+		(unsigned long long) (timestamp_ns / 1000), (unsigned long long) (timestamp_ns % 1000));
+}
+#endif
+
+int pthreadpool_get_trace(
+	struct pthreadpool* threadpool,
+	char* buffer,
+	size_t* size)
+{
+#if PTHREADPOOL_ENABLE_TRACE
+	if (threadpool == NULL || size == NULL) {
+		return EINVAL;
+	}
+	struct trace_writer writer = {
+		.buffer = buffer,
+		.capacity = buffer != NULL ? *size : 0,
+	};
+	write_trace(&writer, "{\"traceEvents\":[");
+	const char* separator = "";
+	for (size_t tid = 0; tid < threadpool->threads_count; tid++) {
+		struct thread_info* thread = &threadpool->threads[tid];
+		write_trace(&writer, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%llu,"
+			"\"args\":{\"name\":\"%s %llu\"}}",
+			separator, (unsigned long long) tid, tid < threadpool->workers_start ? "caller" : "worker",
+			(unsigned long long) tid);
+		separator = ",";
+
+		const uint64_t events_count = __atomic_load_n(&thread->trace_events_count, __ATOMIC_RELAXED);
+		const uint64_t first_event = events_count > PTHREADPOOL_TRACE_EVENTS ? events_count - PTHREADPOOL_TRACE_EVENTS : 0;
+		for (uint64_t position = first_event; position < events_count; position++) {
+			struct trace_event event;
+			if (!read_trace_event(thread, position, &event)) {
+				continue;
+			}
+			switch ((enum trace_event_type) event.type) {
+				case trace_event_job:
+					write_trace(&writer, ",{\"name\":\"job %lu\",\"cat\":\"job\"", (unsigned long) event.value);
+					break;
+				case trace_event_items:
+					write_trace(&writer, ",{\"name\":\"items\",\"cat\":\"items\"");
+					break;
+				case trace_event_steal:
+					write_trace(&writer, ",{\"name\":\"steal from %lu\",\"cat\":\"steal\"", (unsigned long) event.value);
+					break;
+			}
+			write_trace(&writer, ",\"ph\":\"X\",\"pid\":0,\"tid\":%llu,", (unsigned long long) tid);
+			write_trace_timestamp(&writer, "ts", event.start_ns - threadpool->trace_start_ns);
+			write_trace(&writer, ",");
+			write_trace_timestamp(&writer, "dur", event.end_ns - event.start_ns);
+			if (event.type == trace_event_job) {
+				write_trace(&writer, ",\"args\":{\"items\":%llu}}", (unsigned long long) event.range_length);
+			} else {
+				write_trace(&writer, ",\"args\":{\"start\":%llu,\"length\":%llu}}",
+					(unsigned long long) event.range_start, (unsigned long long) event.range_length);
+			}
+		}
+	}
+	write_trace(&writer, "]}");
+
+	/* Account for the terminating null character */
+	const size_t trace_size = writer.length + 1;
+	const bool fits = trace_size <= writer.capacity;
+	*size = trace_size;
+	return fits ? 0 : ENOSPC;
+#else
+	return ENOTSUP;
+#endif
+}
+
+void pthreadpool_compute_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range)
+{
+	pthreadpool_compute_1d_with_flags(threadpool, function, argument, range, 0);
+}
+
+void pthreadpool_compute_1d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i++) {
+			function(argument, i);
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		run_job(threadpool, thread_compute_1d, (void*) function, argument, 0, range, &options, true);
+	}
+}
+
+void pthreadpool_compute_1d_with_max_threads(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t max_threads)
+{
+	if (is_sequential_call(threadpool) || max_threads == 1) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i++) {
+			function(argument, i);
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = max_threads == 0 ? SIZE_MAX : max_threads,
+			.grain = 1,
+			.flags = 0,
+		};
+		run_job(threadpool, thread_compute_1d, (void*) function, argument, 0, range, &options, true);
+	}
+}
+
+void pthreadpool_compute_1d_with_grain(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t grain)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i++) {
+			function(argument, i);
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = grain,
+			.flags = 0,
+		};
+		run_job(threadpool, thread_compute_1d, (void*) function, argument, 0, range, &options, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range)
+{
+	return pthreadpool_submit_1d_with_flags(threadpool, function, argument, range, 0);
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_1d(NULL, function, argument, range);
+		return 0;
+	}
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.flags = flags,
+	};
+	return run_job(threadpool, thread_compute_1d, (void*) function, argument, 0, range, &options, false);
+}
+
+/*
+ * Runs a job with an adapter context synchronously, or submits it with a copy of the context.
+ * Returns the completion handle for the submitted job.
+ */
+static uint32_t parallelize_adapter_with_options(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t adapter,
+	void* context,
+	size_t context_size,
+	size_t range,
+	const struct job_options* options,
+	bool synchronous)
+{
+	/* The context of a synchronous job outlives the job, so it is not copied */
+	return run_job(threadpool, thread_compute_1d, (void*) adapter, context,
+		synchronous ? 0 : context_size, range, options, synchronous);
+}
+
+static uint32_t parallelize_adapter(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t adapter,
+	void* context,
+	size_t context_size,
+	size_t range,
+	bool synchronous)
+{
+	return parallelize_adapter_with_options(threadpool, adapter, context, context_size, range,
+		&default_job_options, synchronous);
+}
+
+void pthreadpool_wait(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+	if (threadpool != NULL && completion != 0) {
+		wait_for_job(threadpool, completion);
+	}
+}
+
+int pthreadpool_test(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+	if (threadpool == NULL || completion == 0) {
+		return 1;
+	}
+	return is_job_completed(__atomic_load_n(&get_job_slot(threadpool, completion)->completed_handle, __ATOMIC_ACQUIRE), completion);
+}
+
+void pthreadpool_cancel(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+	if (threadpool == NULL || completion == 0) {
+		return;
+	}
+	struct job* job = get_job_slot(threadpool, completion);
+	/* As in join_job, registering as a user of the slot keeps it from being reused for another job */
+	__atomic_add_fetch(&job->users, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&job->submitted_handle, __ATOMIC_SEQ_CST) == completion &&
+		__atomic_load_n(&job->completed_handle, __ATOMIC_SEQ_CST) != completion)
+	{
+		__atomic_store_n(&job->cancelled, 1, __ATOMIC_RELAXED);
+	}
+	release_job_slot(threadpool, job);
+}
+
+/* Runs a synchronous cancellable job, and returns non-zero if it was cancelled */
+static int run_cancellable_job(
+	struct pthreadpool* threadpool,
+	void* function,
+	void* argument,
+	size_t range)
+{
+	uint32_t cancelled = 0;
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.flags = 0,
+		.cancellation = &cancelled,
+	};
+	run_job(threadpool, thread_compute_1d_cancellable, function, argument, 0, range, &options, true);
+	/* The threads which cancelled the job accounted for their items after setting the flag */
+	return (int) __atomic_load_n(&cancelled, __ATOMIC_RELAXED);
+}
+
+int pthreadpool_compute_1d_cancellable(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_cancellable_t function,
+	void* argument,
+	size_t range)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i++) {
+			if (function(argument, i) != 0) {
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return run_cancellable_job(threadpool, (void*) function, argument, range);
+}
+
+struct compute_1d_tiled_context {
+	pthreadpool_function_1d_tiled_t function;
+	void* argument;
+	size_t range;
+	size_t tile;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_1d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_1d_tiled context must fit into a job");
+
+static void compute_1d_tiled(const struct compute_1d_tiled_context* context, size_t linear_index) {
+	const size_t tile_index = linear_index;
+	const size_t index = tile_index * context->tile;
+	const size_t tile = min(context->tile, context->range - index);
+	context->function(context->argument, index, tile);
+}
+
+static uint32_t parallelize_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	const struct job_options* options,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range = divide_round_up(range, tile);
+	struct compute_1d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range = range,
+		.tile = tile
+	};
+	return parallelize_adapter_with_options(threadpool, (pthreadpool_function_1d_t) compute_1d_tiled, &context, sizeof(context),
+		tile_range, options, synchronous);
+}
+
+void pthreadpool_compute_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	pthreadpool_compute_1d_tiled_with_flags(threadpool, function, argument, range, tile, 0);
+}
+
+void pthreadpool_compute_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i += tile) {
+			function(argument, i, min(range - i, tile));
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		parallelize_1d_tiled(threadpool, function, argument, range, tile, &options, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	return pthreadpool_submit_1d_tiled_with_flags(threadpool, function, argument, range, tile, 0);
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_1d_tiled(NULL, function, argument, range, tile);
+		return 0;
+	}
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.flags = flags,
+	};
+	return parallelize_1d_tiled(threadpool, function, argument, range, tile, &options, false);
+}
+
+struct compute_1d_tiled_aligned_context {
+	pthreadpool_function_1d_tiled_t function;
+	void* argument;
+	size_t range;
+	size_t tile;
+	size_t head;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_1d_tiled_aligned_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_1d_tiled_aligned context must fit into a job");
+
+static void compute_1d_tiled_aligned(const struct compute_1d_tiled_aligned_context* context, size_t linear_index) {
+	/* Tile 0 is the head of items before the first vector boundary, if there are any */
+	if (context->head != 0) {
+		if (linear_index == 0) {
+			context->function(context->argument, 0, context->head);
+			return;
+		}
+		linear_index -= 1;
+	}
+	const size_t index = context->head + linear_index * context->tile;
+	const size_t tile = min(context->tile, context->range - index);
+	context->function(context->argument, index, tile);
+}
+
+void pthreadpool_compute_1d_tiled_aligned(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width)
+{
+	pthreadpool_compute_1d_tiled_aligned_with_flags(threadpool, function, argument, range, tile, offset, vector_width, 0);
+}
+
+void pthreadpool_compute_1d_tiled_aligned_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width,
+	uint32_t flags)
+{
+	const size_t head = get_aligned_head(range, offset, vector_width);
+	tile = get_aligned_tile(tile, vector_width);
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		if (head != 0) {
+			function(argument, 0, head);
+		}
+		for (size_t i = head; i < range; i += tile) {
+			function(argument, i, min(range - i, tile));
+		}
+	} else {
+		/* Execute in parallel on the thread pool using linearized index */
+		const size_t tile_range = (size_t) (head != 0) + divide_round_up(range - head, tile);
+		struct compute_1d_tiled_aligned_context context = {
+			.function = function,
+			.argument = argument,
+			.range = range,
+			.tile = tile,
+			.head = head
+		};
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		parallelize_adapter_with_options(threadpool, (pthreadpool_function_1d_t) compute_1d_tiled_aligned, &context, sizeof(context),
+			tile_range, &options, true);
+	}
+}
+
+struct compute_1d_tiled_cancellable_context {
+	pthreadpool_function_1d_tiled_cancellable_t function;
+	void* argument;
+	size_t range;
+	size_t tile;
+};
+
+static int compute_1d_tiled_cancellable(const struct compute_1d_tiled_cancellable_context* context, size_t linear_index) {
+	const size_t tile_index = linear_index;
+	const size_t index = tile_index * context->tile;
+	const size_t tile = min(context->tile, context->range - index);
+	return context->function(context->argument, index, tile);
+}
+
+int pthreadpool_compute_1d_tiled_cancellable(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_cancellable_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i += tile) {
+			if (function(argument, i, min(range - i, tile)) != 0) {
+				return 1;
+			}
+		}
+		return 0;
+	}
+	struct compute_1d_tiled_cancellable_context context = {
+		.function = function,
+		.argument = argument,
+		.range = range,
+		.tile = tile
+	};
+	return run_cancellable_job(threadpool, (void*) compute_1d_tiled_cancellable, &context, divide_round_up(range, tile));
+}
+
+struct compute_2d_context {
+	pthreadpool_function_2d_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t range_j;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_2d_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_2d context must fit into a job");
+
+static void compute_2d(const struct compute_2d_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t range_j = context->range_j;
+	const struct fxdiv_result_size_t index = fxdiv_divide_size_t(linear_index, range_j);
+	context->function(context->argument, index.quotient, index.remainder);
+}
+
+static uint32_t parallelize_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	const struct job_options* options,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	struct compute_2d_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j)
+	};
+	return parallelize_adapter_with_options(threadpool, (pthreadpool_function_1d_t) compute_2d, &context, sizeof(context),
+		range_i * range_j, options, synchronous);
+}
+
+void pthreadpool_compute_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j)
+{
+	pthreadpool_compute_2d_with_flags(threadpool, function, argument, range_i, range_j, 0);
+}
+
+void pthreadpool_compute_2d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	uint32_t flags)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				function(argument, i, j);
+			}
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		parallelize_2d(threadpool, function, argument, range_i, range_j, &options, true);
+	}
+}
+
+void pthreadpool_compute_2d_with_grain(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t grain)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				function(argument, i, j);
+			}
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = grain,
+			.flags = 0,
+		};
+		parallelize_2d(threadpool, function, argument, range_i, range_j, &options, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_2d(NULL, function, argument, range_i, range_j);
+		return 0;
+	}
+	return parallelize_2d(threadpool, function, argument, range_i, range_j, &default_job_options, false);
+}
+
+struct compute_2d_tiled_context {
+	pthreadpool_function_2d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t tile_range_j;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_2d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_2d_tiled context must fit into a job");
+
+static void compute_2d_tiled(const struct compute_2d_tiled_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_j = context->tile_range_j;
+	const struct fxdiv_result_size_t tile_index = fxdiv_divide_size_t(linear_index, tile_range_j);
+	const size_t max_tile_i = context->tile_i;
+	const size_t max_tile_j = context->tile_j;
+	const size_t index_i = tile_index.quotient * max_tile_i;
+	const size_t index_j = tile_index.remainder * max_tile_j;
+	const size_t tile_i = min(max_tile_i, context->range_i - index_i);
+	const size_t tile_j = min(max_tile_j, context->range_j - index_j);
+	context->function(context->argument, index_i, index_j, tile_i, tile_j);
+}
+
+/* Context of the adapters for the traversal orders of 2D tiles other than row-major */
+struct compute_2d_tiled_ordered_context {
+	pthreadpool_function_2d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t tile_range_i;
+	struct tile_curve curve;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_2d_tiled_ordered_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_2d_tiled_ordered context must fit into a job");
+
+static inline void call_2d_tiled(const struct compute_2d_tiled_ordered_context* context, size_t tile_index_i, size_t tile_index_j) {
+	const size_t index_i = tile_index_i * context->tile_i;
+	const size_t index_j = tile_index_j * context->tile_j;
+	const size_t tile_i = min(context->tile_i, context->range_i - index_i);
+	const size_t tile_j = min(context->tile_j, context->range_j - index_j);
+	context->function(context->argument, index_i, index_j, tile_i, tile_j);
+}
+
+static void compute_2d_tiled_column_major(const struct compute_2d_tiled_ordered_context* context, size_t linear_index) {
+	const struct fxdiv_result_size_t tile_index = fxdiv_divide_size_t(linear_index, context->tile_range_i);
+	call_2d_tiled(context, tile_index.remainder, tile_index.quotient);
+}
+
+static void compute_2d_tiled_curve(const struct compute_2d_tiled_ordered_context* context, size_t linear_index) {
+	size_t tile_index[2];
+	locate_curve_tile(&context->curve, linear_index, tile_index);
+	call_2d_tiled(context, tile_index[0], tile_index[1]);
+}
+
+/* Initializes the context for a traversal order other than row-major, and returns the adapter which follows it */
+static pthreadpool_function_1d_t init_2d_tiled_ordered_context(
+	struct compute_2d_tiled_ordered_context* context,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t traversal)
+{
+	const size_t tile_ranges[2] = { divide_round_up(range_i, tile_i), divide_round_up(range_j, tile_j) };
+	*context = (struct compute_2d_tiled_ordered_context) {
+		.function = function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+	};
+	if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR) {
+		context->tile_range_i = fxdiv_init_size_t(tile_ranges[0]);
+		return (pthreadpool_function_1d_t) compute_2d_tiled_column_major;
+	} else {
+		context->curve = make_tile_curve(2, tile_ranges, traversal == PTHREADPOOL_FLAG_TRAVERSAL_HILBERT);
+		return (pthreadpool_function_1d_t) compute_2d_tiled_curve;
+	}
+}
+
+static uint32_t parallelize_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	const struct job_options* options,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range_i = divide_round_up(range_i, tile_i);
+	const size_t tile_range_j = divide_round_up(range_j, tile_j);
+	const uint32_t traversal = options->flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (traversal != PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		struct compute_2d_tiled_ordered_context context;
+		const pthreadpool_function_1d_t adapter =
+			init_2d_tiled_ordered_context(&context, function, argument, range_i, range_j, tile_i, tile_j, traversal);
+		return parallelize_adapter_with_options(threadpool, adapter, &context, sizeof(context),
+			tile_range_i * tile_range_j, options, synchronous);
+	}
+	struct compute_2d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.tile_range_j = fxdiv_init_size_t(tile_range_j),
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j
+	};
+	return parallelize_adapter_with_options(threadpool, (pthreadpool_function_1d_t) compute_2d_tiled, &context, sizeof(context),
+		tile_range_i * tile_range_j, options, synchronous);
+}
+
+void pthreadpool_compute_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	pthreadpool_compute_2d_tiled_with_flags(threadpool, function, argument, range_i, range_j, tile_i, tile_j, 0);
+}
+
+void pthreadpool_compute_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags)
+{
+	const uint32_t traversal = flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (is_sequential_call(threadpool) && traversal != PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		/* No thread pool used: execute function sequentially on the calling thread, in the traversal order */
+		struct compute_2d_tiled_ordered_context context;
+		const pthreadpool_function_1d_t adapter =
+			init_2d_tiled_ordered_context(&context, function, argument, range_i, range_j, tile_i, tile_j, traversal);
+		const size_t tiles_count = divide_round_up(range_i, tile_i) * divide_round_up(range_j, tile_j);
+		for (size_t linear_index = 0; linear_index < tiles_count; linear_index++) {
+			adapter(&context, linear_index);
+		}
+	} else if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i += tile_i) {
+			for (size_t j = 0; j < range_j; j += tile_j) {
+				function(argument, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
+			}
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		parallelize_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j, &options, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	return pthreadpool_submit_2d_tiled_with_flags(threadpool, function, argument, range_i, range_j, tile_i, tile_j, 0);
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		/* Follows the traversal order of the flags */
+		pthreadpool_compute_2d_tiled_with_flags(NULL, function, argument, range_i, range_j, tile_i, tile_j, flags);
+		return 0;
+	}
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.flags = flags,
+	};
+	return parallelize_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j, &options, false);
+}
+
+struct compute_3d_context {
+	pthreadpool_function_3d_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t range_j;
+	struct fxdiv_divisor_size_t range_k;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_3d_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_3d context must fit into a job");
+
+static void compute_3d(const struct compute_3d_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t range_k = context->range_k;
+	const struct fxdiv_result_size_t index_ij_k = fxdiv_divide_size_t(linear_index, range_k);
+	const struct fxdiv_divisor_size_t range_j = context->range_j;
+	const struct fxdiv_result_size_t index_i_j = fxdiv_divide_size_t(index_ij_k.quotient, range_j);
+	context->function(context->argument, index_i_j.quotient, index_i_j.remainder, index_ij_k.remainder);
+}
+
+static uint32_t parallelize_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	struct compute_3d_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j),
+		.range_k = fxdiv_init_size_t(range_k)
+	};
+	return parallelize_adapter(threadpool, (pthreadpool_function_1d_t) compute_3d, &context, sizeof(context), range_i * range_j * range_k, synchronous);
+}
+
+void pthreadpool_compute_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				for (size_t k = 0; k < range_k; k++) {
+					function(argument, i, j, k);
+				}
+			}
+		}
+	} else {
+		parallelize_3d(threadpool, function, argument, range_i, range_j, range_k, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_3d(NULL, function, argument, range_i, range_j, range_k);
+		return 0;
+	}
+	return parallelize_3d(threadpool, function, argument, range_i, range_j, range_k, false);
+}
+
+struct compute_3d_tiled_context {
+	pthreadpool_function_3d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t tile_range_j;
+	struct fxdiv_divisor_size_t tile_range_k;
+	size_t range_i;
+	size_t range_j;
+	size_t range_k;
+	size_t tile_i;
+	size_t tile_j;
+	size_t tile_k;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_3d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_3d_tiled context must fit into a job");
+
+static void compute_3d_tiled(const struct compute_3d_tiled_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_k = context->tile_range_k;
+	const struct fxdiv_result_size_t tile_index_ij_k = fxdiv_divide_size_t(linear_index, tile_range_k);
+	const struct fxdiv_divisor_size_t tile_range_j = context->tile_range_j;
+	const struct fxdiv_result_size_t tile_index_i_j = fxdiv_divide_size_t(tile_index_ij_k.quotient, tile_range_j);
+	const size_t max_tile_i = context->tile_i;
+	const size_t max_tile_j = context->tile_j;
+	const size_t max_tile_k = context->tile_k;
+	const size_t index_i = tile_index_i_j.quotient * max_tile_i;
+	const size_t index_j = tile_index_i_j.remainder * max_tile_j;
+	const size_t index_k = tile_index_ij_k.remainder * max_tile_k;
+	const size_t tile_i = min(max_tile_i, context->range_i - index_i);
+	const size_t tile_j = min(max_tile_j, context->range_j - index_j);
+	const size_t tile_k = min(max_tile_k, context->range_k - index_k);
+	context->function(context->argument, index_i, index_j, index_k, tile_i, tile_j, tile_k);
+}
+
+/* Context of the adapters for the traversal orders of 3D tiles other than row-major */
+struct compute_3d_tiled_ordered_context {
+	pthreadpool_function_3d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t tile_range_i;
+	struct fxdiv_divisor_size_t tile_range_j;
+	struct tile_curve curve;
+	size_t range_i;
+	size_t range_j;
+	size_t range_k;
+	size_t tile_i;
+	size_t tile_j;
+	size_t tile_k;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_3d_tiled_ordered_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_3d_tiled_ordered context must fit into a job");
+
+static inline void call_3d_tiled(
+	const struct compute_3d_tiled_ordered_context* context,
+	size_t tile_index_i,
+	size_t tile_index_j,
+	size_t tile_index_k)
+{
+	const size_t index_i = tile_index_i * context->tile_i;
+	const size_t index_j = tile_index_j * context->tile_j;
+	const size_t index_k = tile_index_k * context->tile_k;
+	const size_t tile_i = min(context->tile_i, context->range_i - index_i);
+	const size_t tile_j = min(context->tile_j, context->range_j - index_j);
+	const size_t tile_k = min(context->tile_k, context->range_k - index_k);
+	context->function(context->argument, index_i, index_j, index_k, tile_i, tile_j, tile_k);
+}
+
+static void compute_3d_tiled_column_major(const struct compute_3d_tiled_ordered_context* context, size_t linear_index) {
+	const struct fxdiv_result_size_t tile_index_jk_i = fxdiv_divide_size_t(linear_index, context->tile_range_i);
+	const struct fxdiv_result_size_t tile_index_k_j = fxdiv_divide_size_t(tile_index_jk_i.quotient, context->tile_range_j);
+	call_3d_tiled(context, tile_index_jk_i.remainder, tile_index_k_j.remainder, tile_index_k_j.quotient);
+}
+
+static void compute_3d_tiled_curve(const struct compute_3d_tiled_ordered_context* context, size_t linear_index) {
+	size_t tile_index[3];
+	locate_curve_tile(&context->curve, linear_index, tile_index);
+	call_3d_tiled(context, tile_index[0], tile_index[1], tile_index[2]);
+}
+
+/* Initializes the context for a traversal order other than row-major, and returns the adapter which follows it */
+static pthreadpool_function_1d_t init_3d_tiled_ordered_context(
+	struct compute_3d_tiled_ordered_context* context,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k,
+	uint32_t traversal)
+{
+	const size_t tile_ranges[3] = {
+		divide_round_up(range_i, tile_i),
+		divide_round_up(range_j, tile_j),
+		divide_round_up(range_k, tile_k),
+	};
+	*context = (struct compute_3d_tiled_ordered_context) {
+		.function = function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.range_k = range_k,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+		.tile_k = tile_k,
+	};
+	if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR) {
+		context->tile_range_i = fxdiv_init_size_t(tile_ranges[0]);
+		context->tile_range_j = fxdiv_init_size_t(tile_ranges[1]);
+		return (pthreadpool_function_1d_t) compute_3d_tiled_column_major;
+	} else {
+		context->curve = make_tile_curve(3, tile_ranges, traversal == PTHREADPOOL_FLAG_TRAVERSAL_HILBERT);
+		return (pthreadpool_function_1d_t) compute_3d_tiled_curve;
+	}
+}
+
+static uint32_t parallelize_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k,
+	const struct job_options* options,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range_i = divide_round_up(range_i, tile_i);
+	const size_t tile_range_j = divide_round_up(range_j, tile_j);
+	const size_t tile_range_k = divide_round_up(range_k, tile_k);
+	const uint32_t traversal = options->flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (traversal != PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		struct compute_3d_tiled_ordered_context context;
+		const pthreadpool_function_1d_t adapter = init_3d_tiled_ordered_context(&context, function, argument,
+			range_i, range_j, range_k, tile_i, tile_j, tile_k, traversal);
+		return parallelize_adapter_with_options(threadpool, adapter, &context, sizeof(context),
+			tile_range_i * tile_range_j * tile_range_k, options, synchronous);
+	}
+	struct compute_3d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.tile_range_j = fxdiv_init_size_t(tile_range_j),
+		.tile_range_k = fxdiv_init_size_t(tile_range_k),
+		.range_i = range_i,
+		.range_j = range_j,
+		.range_k = range_k,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+		.tile_k = tile_k
+	};
+	return parallelize_adapter_with_options(threadpool, (pthreadpool_function_1d_t) compute_3d_tiled, &context, sizeof(context),
+		tile_range_i * tile_range_j * tile_range_k, options, synchronous);
+}
+
+void pthreadpool_compute_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k)
+{
+	pthreadpool_compute_3d_tiled_with_flags(threadpool, function, argument,
+		range_i, range_j, range_k, tile_i, tile_j, tile_k, 0);
+}
+
+void pthreadpool_compute_3d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k,
+	uint32_t flags)
+{
+	const uint32_t traversal = flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (is_sequential_call(threadpool) && traversal != PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		/* No thread pool used: execute function sequentially on the calling thread, in the traversal order */
+		struct compute_3d_tiled_ordered_context context;
+		const pthreadpool_function_1d_t adapter = init_3d_tiled_ordered_context(&context, function, argument,
+			range_i, range_j, range_k, tile_i, tile_j, tile_k, traversal);
+		const size_t tiles_count =
+			divide_round_up(range_i, tile_i) * divide_round_up(range_j, tile_j) * divide_round_up(range_k, tile_k);
+		for (size_t linear_index = 0; linear_index < tiles_count; linear_index++) {
+			adapter(&context, linear_index);
+		}
+	} else if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i += tile_i) {
+			for (size_t j = 0; j < range_j; j += tile_j) {
+				for (size_t k = 0; k < range_k; k += tile_k) {
+					function(argument, i, j, k,
+						min(range_i - i, tile_i), min(range_j - j, tile_j), min(range_k - k, tile_k));
+				}
+			}
+		}
+	} else {
+		const struct job_options options = {
+			.max_threads_count = SIZE_MAX,
+			.grain = 1,
+			.flags = flags,
+		};
+		parallelize_3d_tiled(threadpool, function, argument, range_i, range_j, range_k, tile_i, tile_j, tile_k, &options, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_3d_tiled(NULL, function, argument, range_i, range_j, range_k, tile_i, tile_j, tile_k);
+		return 0;
+	}
+	return parallelize_3d_tiled(threadpool, function, argument, range_i, range_j, range_k, tile_i, tile_j, tile_k,
+		&default_job_options, false);
+}
+
+struct compute_4d_tiled_context {
+	pthreadpool_function_4d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t range_j;
+	struct fxdiv_divisor_size_t tile_range_k;
+	struct fxdiv_divisor_size_t tile_range_l;
+	size_t range_k;
+	size_t range_l;
+	size_t tile_k;
+	size_t tile_l;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_4d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_4d_tiled context must fit into a job");
+
+static void compute_4d_tiled(const struct compute_4d_tiled_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_l = context->tile_range_l;
+	const struct fxdiv_result_size_t tile_index_ijk_l = fxdiv_divide_size_t(linear_index, tile_range_l);
+	const struct fxdiv_divisor_size_t tile_range_k = context->tile_range_k;
+	const struct fxdiv_result_size_t tile_index_ij_k = fxdiv_divide_size_t(tile_index_ijk_l.quotient, tile_range_k);
+	const struct fxdiv_divisor_size_t range_j = context->range_j;
+	const struct fxdiv_result_size_t index_i_j = fxdiv_divide_size_t(tile_index_ij_k.quotient, range_j);
+	const size_t max_tile_k = context->tile_k;
+	const size_t max_tile_l = context->tile_l;
+	const size_t index_k = tile_index_ij_k.remainder * max_tile_k;
+	const size_t index_l = tile_index_ijk_l.remainder * max_tile_l;
+	const size_t tile_k = min(max_tile_k, context->range_k - index_k);
+	const size_t tile_l = min(max_tile_l, context->range_l - index_l);
+	context->function(context->argument, index_i_j.quotient, index_i_j.remainder, index_k, index_l, tile_k, tile_l);
+}
+
+static uint32_t parallelize_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range_k = divide_round_up(range_k, tile_k);
+	const size_t tile_range_l = divide_round_up(range_l, tile_l);
+	struct compute_4d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j),
+		.tile_range_k = fxdiv_init_size_t(tile_range_k),
+		.tile_range_l = fxdiv_init_size_t(tile_range_l),
+		.range_k = range_k,
+		.range_l = range_l,
+		.tile_k = tile_k,
+		.tile_l = tile_l
+	};
+	return parallelize_adapter(threadpool, (pthreadpool_function_1d_t) compute_4d_tiled, &context, sizeof(context),
+		range_i * range_j * tile_range_k * tile_range_l, synchronous);
+}
+
+void pthreadpool_compute_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				for (size_t k = 0; k < range_k; k += tile_k) {
+					for (size_t l = 0; l < range_l; l += tile_l) {
+						function(argument, i, j, k, l, min(range_k - k, tile_k), min(range_l - l, tile_l));
+					}
+				}
+			}
+		}
+	} else {
+		parallelize_4d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, tile_k, tile_l, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_4d_tiled(NULL, function, argument, range_i, range_j, range_k, range_l, tile_k, tile_l);
+		return 0;
+	}
+	return parallelize_4d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, tile_k, tile_l, false);
+}
+
+struct compute_5d_tiled_context {
+	pthreadpool_function_5d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t range_j;
+	struct fxdiv_divisor_size_t range_k;
+	struct fxdiv_divisor_size_t tile_range_l;
+	struct fxdiv_divisor_size_t tile_range_m;
+	size_t range_l;
+	size_t range_m;
+	size_t tile_l;
+	size_t tile_m;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_5d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_5d_tiled context must fit into a job");
+
+static void compute_5d_tiled(const struct compute_5d_tiled_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_m = context->tile_range_m;
+	const struct fxdiv_result_size_t tile_index_ijkl_m = fxdiv_divide_size_t(linear_index, tile_range_m);
+	const struct fxdiv_divisor_size_t tile_range_l = context->tile_range_l;
+	const struct fxdiv_result_size_t tile_index_ijk_l = fxdiv_divide_size_t(tile_index_ijkl_m.quotient, tile_range_l);
+	const struct fxdiv_divisor_size_t range_k = context->range_k;
+	const struct fxdiv_result_size_t index_ij_k = fxdiv_divide_size_t(tile_index_ijk_l.quotient, range_k);
+	const struct fxdiv_divisor_size_t range_j = context->range_j;
+	const struct fxdiv_result_size_t index_i_j = fxdiv_divide_size_t(index_ij_k.quotient, range_j);
+	const size_t max_tile_l = context->tile_l;
+	const size_t max_tile_m = context->tile_m;
+	const size_t index_l = tile_index_ijk_l.remainder * max_tile_l;
+	const size_t index_m = tile_index_ijkl_m.remainder * max_tile_m;
+	const size_t tile_l = min(max_tile_l, context->range_l - index_l);
+	const size_t tile_m = min(max_tile_m, context->range_m - index_m);
+	context->function(context->argument, index_i_j.quotient, index_i_j.remainder, index_ij_k.remainder,
+		index_l, index_m, tile_l, tile_m);
+}
+
+static uint32_t parallelize_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range_l = divide_round_up(range_l, tile_l);
+	const size_t tile_range_m = divide_round_up(range_m, tile_m);
+	struct compute_5d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j),
+		.range_k = fxdiv_init_size_t(range_k),
+		.tile_range_l = fxdiv_init_size_t(tile_range_l),
+		.tile_range_m = fxdiv_init_size_t(tile_range_m),
+		.range_l = range_l,
+		.range_m = range_m,
+		.tile_l = tile_l,
+		.tile_m = tile_m
+	};
+	return parallelize_adapter(threadpool, (pthreadpool_function_1d_t) compute_5d_tiled, &context, sizeof(context),
+		range_i * range_j * range_k * tile_range_l * tile_range_m, synchronous);
+}
+
+void pthreadpool_compute_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				for (size_t k = 0; k < range_k; k++) {
+					for (size_t l = 0; l < range_l; l += tile_l) {
+						for (size_t m = 0; m < range_m; m += tile_m) {
+							function(argument, i, j, k, l, m, min(range_l - l, tile_l), min(range_m - m, tile_m));
+						}
+					}
+				}
+			}
+		}
+	} else {
+		parallelize_5d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, tile_l, tile_m, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_5d_tiled(NULL, function, argument, range_i, range_j, range_k, range_l, range_m, tile_l, tile_m);
+		return 0;
+	}
+	return parallelize_5d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, tile_l, tile_m, false);
+}
+
+struct compute_6d_tiled_context {
+	pthreadpool_function_6d_tiled_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t range_j;
+	struct fxdiv_divisor_size_t range_k;
+	struct fxdiv_divisor_size_t range_l;
+	struct fxdiv_divisor_size_t tile_range_m;
+	struct fxdiv_divisor_size_t tile_range_n;
+	size_t range_m;
+	size_t range_n;
+	size_t tile_m;
+	size_t tile_n;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct compute_6d_tiled_context) <= PTHREADPOOL_JOB_CONTEXT_SIZE, "compute_6d_tiled context must fit into a job");
+
+static void compute_6d_tiled(const struct compute_6d_tiled_context* context, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_n = context->tile_range_n;
+	const struct fxdiv_result_size_t tile_index_ijklm_n = fxdiv_divide_size_t(linear_index, tile_range_n);
+	const struct fxdiv_divisor_size_t tile_range_m = context->tile_range_m;
+	const struct fxdiv_result_size_t tile_index_ijkl_m = fxdiv_divide_size_t(tile_index_ijklm_n.quotient, tile_range_m);
+	const struct fxdiv_divisor_size_t range_l = context->range_l;
+	const struct fxdiv_result_size_t index_ijk_l = fxdiv_divide_size_t(tile_index_ijkl_m.quotient, range_l);
+	const struct fxdiv_divisor_size_t range_k = context->range_k;
+	const struct fxdiv_result_size_t index_ij_k = fxdiv_divide_size_t(index_ijk_l.quotient, range_k);
+	const struct fxdiv_divisor_size_t range_j = context->range_j;
+	const struct fxdiv_result_size_t index_i_j = fxdiv_divide_size_t(index_ij_k.quotient, range_j);
+	const size_t max_tile_m = context->tile_m;
+	const size_t max_tile_n = context->tile_n;
+	const size_t index_m = tile_index_ijkl_m.remainder * max_tile_m;
+	const size_t index_n = tile_index_ijklm_n.remainder * max_tile_n;
+	const size_t tile_m = min(max_tile_m, context->range_m - index_m);
+	const size_t tile_n = min(max_tile_n, context->range_n - index_n);
+	context->function(context->argument, index_i_j.quotient, index_i_j.remainder, index_ij_k.remainder, index_ijk_l.remainder,
+		index_m, index_n, tile_m, tile_n);
+}
+
+static uint32_t parallelize_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n,
+	bool synchronous)
+{
+	/* Execute in parallel on the thread pool using linearized index */
+	const size_t tile_range_m = divide_round_up(range_m, tile_m);
+	const size_t tile_range_n = divide_round_up(range_n, tile_n);
+	struct compute_6d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j),
+		.range_k = fxdiv_init_size_t(range_k),
+		.range_l = fxdiv_init_size_t(range_l),
+		.tile_range_m = fxdiv_init_size_t(tile_range_m),
+		.tile_range_n = fxdiv_init_size_t(tile_range_n),
+		.range_m = range_m,
+		.range_n = range_n,
+		.tile_m = tile_m,
+		.tile_n = tile_n
+	};
+	return parallelize_adapter(threadpool, (pthreadpool_function_1d_t) compute_6d_tiled, &context, sizeof(context),
+		range_i * range_j * range_k * range_l * tile_range_m * tile_range_n, synchronous);
+}
+
+void pthreadpool_compute_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range_i; i++) {
+			for (size_t j = 0; j < range_j; j++) {
+				for (size_t k = 0; k < range_k; k++) {
+					for (size_t l = 0; l < range_l; l++) {
+						for (size_t m = 0; m < range_m; m += tile_m) {
+							for (size_t n = 0; n < range_n; n += tile_n) {
+								function(argument, i, j, k, l, m, n, min(range_m - m, tile_m), min(range_n - n, tile_n));
+							}
+						}
+					}
+				}
+			}
+		}
+	} else {
+		parallelize_6d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, range_n, tile_m, tile_n, true);
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		pthreadpool_compute_6d_tiled(NULL, function, argument, range_i, range_j, range_k, range_l, range_m, range_n, tile_m, tile_n);
+		return 0;
+	}
+	return parallelize_6d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, range_n, tile_m, tile_n, false);
+}
+
+/*
+ * Grows the scratch memory of every thread to at least scratch_size bytes.
+ * The caller must hold the scratch mutex. Returns false if memory can't be allocated.
+ *
+ * Scratch memory is allocated separately for each thread on the first call which needs it, rather than with the
+ * thread pool: the size is not known when the pool is created, pools which never use scratch memory pay nothing,
+ * and growing it doesn't move the thread pool, whose work segments follow the thread information structures.
+ */
+static bool reserve_scratch(struct pthreadpool* threadpool, size_t scratch_size) {
+	/* Round up to whole cache lines so that no two threads' scratch memory share a cache line */
+	scratch_size = divide_round_up(scratch_size, PTHREADPOOL_CACHELINE_SIZE) * PTHREADPOOL_CACHELINE_SIZE;
+	for (size_t tid = 0; tid < threadpool->threads_count; tid++) {
+		struct thread_info* thread = &threadpool->threads[tid];
+		if (thread->scratch_size < scratch_size) {
+			pthreadpool_deallocate(thread->scratch);
+			thread->scratch_size = 0;
+			thread->scratch = pthreadpool_allocate(scratch_size);
+			if (thread->scratch == NULL) {
+				return false;
+			}
+			thread->scratch_size = scratch_size;
+		}
+	}
+	return true;
+}
+
+struct compute_2d_tiled_with_scratch_context {
+	pthreadpool_function_2d_tiled_with_scratch_t function;
+	void* argument;
+	struct fxdiv_divisor_size_t tile_range_j;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+static void compute_2d_tiled_with_scratch(const struct compute_2d_tiled_with_scratch_context* context, struct thread_info* thread, size_t linear_index) {
+	const struct fxdiv_divisor_size_t tile_range_j = context->tile_range_j;
+	const struct fxdiv_result_size_t tile_index = fxdiv_divide_size_t(linear_index, tile_range_j);
+	const size_t max_tile_i = context->tile_i;
+	const size_t max_tile_j = context->tile_j;
+	const size_t index_i = tile_index.quotient * max_tile_i;
+	const size_t index_j = tile_index.remainder * max_tile_j;
+	const size_t tile_i = min(max_tile_i, context->range_i - index_i);
+	const size_t tile_j = min(max_tile_j, context->range_j - index_j);
+	context->function(context->argument, thread->thread_number, thread->scratch, index_i, index_j, tile_i, tile_j);
+}
+
+int pthreadpool_compute_2d_tiled_with_scratch(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_with_scratch_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t scratch_size)
+{
+	if (threadpool == NULL || is_nested_call()) {
+		/* No thread pool provided, or a nested call: execute function sequentially with a temporary scratch memory */
+		void* scratch = NULL;
+		if (scratch_size != 0) {
+			scratch = pthreadpool_allocate(scratch_size);
+			if (scratch == NULL) {
+				return ENOMEM;
+			}
+		}
+		for (size_t i = 0; i < range_i; i += tile_i) {
+			for (size_t j = 0; j < range_j; j += tile_j) {
+				function(argument, 0, scratch, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
+			}
+		}
+		pthreadpool_deallocate(scratch);
+		return 0;
+	}
+
+	/* Only jobs started by this function use the scratch memory: while they are serialized, it can be resized */
+	pthreadpool_mutex_lock(&threadpool->scratch_mutex);
+	if (!reserve_scratch(threadpool, scratch_size)) {
+		pthreadpool_mutex_unlock(&threadpool->scratch_mutex);
+		return ENOMEM;
+	}
+
+	if (get_enabled_threads_count(threadpool) <= 1) {
+		/* Execute function sequentially on the calling thread with the scratch memory of thread 0 */
+		void* scratch = threadpool->threads[0].scratch;
+		for (size_t i = 0; i < range_i; i += tile_i) {
+			for (size_t j = 0; j < range_j; j += tile_j) {
+				function(argument, 0, scratch, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
+			}
+		}
+	} else {
+		/* Execute in parallel on the thread pool using linearized index */
+		const size_t tile_range_i = divide_round_up(range_i, tile_i);
+		const size_t tile_range_j = divide_round_up(range_j, tile_j);
+		struct compute_2d_tiled_with_scratch_context context = {
+			.function = function,
+			.argument = argument,
+			.tile_range_j = fxdiv_init_size_t(tile_range_j),
+			.range_i = range_i,
+			.range_j = range_j,
+			.tile_i = tile_i,
+			.tile_j = tile_j
+		};
+		/* The context outlives the job, so it is not copied */
+		run_job(threadpool, thread_compute_1d_with_thread,
+			(void*) compute_2d_tiled_with_scratch, &context, 0, tile_range_i * tile_range_j, &default_job_options, true);
+	}
+	pthreadpool_mutex_unlock(&threadpool->scratch_mutex);
+	return 0;
+}
+
+struct reduce_1d_context {
+	pthreadpool_function_reduce_1d_t function;
+	void* argument;
+};
+
+static void reduce_1d(const struct reduce_1d_context* context, struct thread_info* thread, size_t linear_index) {
+	context->function(context->argument, thread->scratch, linear_index);
+}
+
+struct reduce_1d_tiled_context {
+	pthreadpool_function_reduce_1d_tiled_t function;
+	void* argument;
+	size_t range;
+	size_t tile;
+};
+
+static void reduce_1d_tiled(const struct reduce_1d_tiled_context* context, struct thread_info* thread, size_t linear_index) {
+	const size_t tile_index = linear_index;
+	const size_t index = tile_index * context->tile;
+	const size_t tile = min(context->tile, context->range - index);
+	context->function(context->argument, thread->scratch, index, tile);
+}
+
+/*
+ * Runs a reduction job: every thread accumulates into its own copy of the initial accumulator value in its scratch
+ * memory, and then the copies are combined into the accumulator.
+ */
+static int parallelize_reduce(
+	struct pthreadpool* threadpool,
+	thread_function_1d_t adapter,
+	void* context,
+	size_t range,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size)
+{
+	/* The per-thread accumulators are the scratch memory, which is padded to whole cache lines */
+	pthreadpool_mutex_lock(&threadpool->scratch_mutex);
+	if (!reserve_scratch(threadpool, accumulator_size)) {
+		pthreadpool_mutex_unlock(&threadpool->scratch_mutex);
+		return ENOMEM;
+	}
+
+	const size_t threads_count = threadpool->threads_count;
+	struct thread_info* threads = threadpool->threads;
+	for (size_t tid = 0; tid < threads_count; tid++) {
+		memcpy(threads[tid].scratch, accumulator, accumulator_size);
+	}
+
+	/* The context outlives the job, so it is not copied */
+	run_job(threadpool, thread_compute_1d_with_thread, (void*) adapter, context, 0, range, &default_job_options, true);
+
+	/* Combine the accumulators pairwise, as a balanced tree, into the accumulator of thread 0 */
+	for (size_t stride = 1; stride < threads_count; stride *= 2) {
+		for (size_t tid = 0; tid + stride < threads_count; tid += 2 * stride) {
+			combine(argument, threads[tid].scratch, threads[tid + stride].scratch);
+		}
+	}
+	memcpy(accumulator, threads[0].scratch, accumulator_size);
+
+	pthreadpool_mutex_unlock(&threadpool->scratch_mutex);
+	return 0;
+}
+
+int pthreadpool_reduce_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_reduce_1d_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: accumulate sequentially on the calling thread, and nothing to combine */
+		for (size_t i = 0; i < range; i++) {
+			function(argument, accumulator, i);
+		}
+		return 0;
+	}
+
+	struct reduce_1d_context context = {
+		.function = function,
+		.argument = argument
+	};
+	return parallelize_reduce(threadpool, (thread_function_1d_t) reduce_1d, &context, range,
+		combine, argument, accumulator, accumulator_size);
+}
+
+int pthreadpool_reduce_1d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_reduce_1d_tiled_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range,
+	size_t tile)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: accumulate sequentially on the calling thread, and nothing to combine */
+		for (size_t i = 0; i < range; i += tile) {
+			function(argument, accumulator, i, min(range - i, tile));
+		}
+		return 0;
+	}
+
+	struct reduce_1d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range = range,
+		.tile = tile
+	};
+	return parallelize_reduce(threadpool, (thread_function_1d_t) reduce_1d_tiled, &context, divide_round_up(range, tile),
+		combine, argument, accumulator, accumulator_size);
+}
+
+/*
+ * Returns a node of the graph which has unclaimed items and no pending dependencies, or NULL if there are no such nodes.
+ * Advances graph->first_unclaimed_node past the completely claimed nodes it finds.
+ */
+static struct graph_node* find_ready_graph_node(struct pthreadpool_graph* graph) {
+	struct graph_node* nodes = graph->nodes;
+	const size_t nodes_count = graph->nodes_count;
+	size_t first_unclaimed_node = __atomic_load_n(&graph->first_unclaimed_node, __ATOMIC_RELAXED);
+	bool claimed_before = true;
+	for (size_t i = first_unclaimed_node; i < nodes_count; i++) {
+		struct graph_node* node = &nodes[i];
+		if (__atomic_load_n(&node->claimed_items, __ATOMIC_RELAXED) >= node->range) {
+			if (claimed_before) {
+				/* Fails harmlessly if another thread advanced past this node already */
+				size_t expected_node = i;
+				__atomic_compare_exchange_n(&graph->first_unclaimed_node, &expected_node, i + 1,
+					false /* strong */, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+			}
+			continue;
+		}
+		claimed_before = false;
+		/* The acquire half of the load pairs with the release of the dependencies' results in complete_graph_node */
+		if (__atomic_load_n(&node->pending_dependencies, __ATOMIC_ACQUIRE) == 0) {
+			return node;
+		}
+	}
+	return NULL;
+}
+
+/* Checks if all items of all nodes of the graph are claimed */
+static inline bool is_graph_claimed(struct pthreadpool_graph* graph) {
+	return __atomic_load_n(&graph->first_unclaimed_node, __ATOMIC_RELAXED) == graph->nodes_count;
+}
+
+/* Releases the nodes which depend on the completed node, and wakes up the threads waiting for ready nodes */
+static void complete_graph_node(struct pthreadpool_graph* graph, struct graph_node* node) {
+	struct graph_node* nodes = graph->nodes;
+	const size_t* dependents = graph->dependents + node->dependents_start;
+	for (size_t i = 0; i < node->dependents_count; i++) {
+		/* The release half publishes the results of this node to the threads which process the dependent node */
+		__atomic_sub_fetch(&nodes[dependents[i]].pending_dependencies, 1, __ATOMIC_ACQ_REL);
+	}
+
+	/*
+	 * Sequentially consistent ordering pairs with the registration of waiters in wait_for_ready_graph_node:
+	 * either a waiter observes the event, or we observe the waiter and wake it up.
+	 */
+	__atomic_add_fetch(&graph->events, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&graph->waiters, __ATOMIC_SEQ_CST) != 0) {
+		pthreadpool_futex_wake_all(&graph->events);
+	}
+}
+
+/*
+ * Waits until a node of the graph becomes ready, all nodes are claimed, or a new job is submitted to the thread pool.
+ * Nodes become ready only when other nodes complete, which wakes up the waiter. Sleeping threads are not woken up by
+ * new jobs, and rebalance only after the next node completes.
+ */
+static void wait_for_ready_graph_node(
+	struct pthreadpool* threadpool,
+	struct thread_info* thread,
+	struct pthreadpool_graph* graph,
+	uint32_t command)
+{
+	/* Spin-wait for a while: if the dependencies complete soon, this avoids a futex round-trip on both sides */
+	const uint32_t spin_wait_iterations = __atomic_load_n(&threadpool->spin_wait_iterations, __ATOMIC_RELAXED);
+	for (uint32_t i = 0; i < spin_wait_iterations; i++) {
+		if (has_new_command(threadpool, command) || is_graph_claimed(graph) || find_ready_graph_node(graph) != NULL) {
+			PTHREADPOOL_STATS_ADD(thread, spin_iterations, i);
+			return;
+		}
+		pthreadpool_spin_wait_hint();
+	}
+	PTHREADPOOL_STATS_ADD(thread, spin_iterations, spin_wait_iterations);
+
+	/* The dependencies are still running: register as a waiter and fall back to sleeping on a futex */
+	__atomic_add_fetch(&graph->waiters, 1, __ATOMIC_SEQ_CST);
+	for (;;) {
+		const uint32_t events = __atomic_load_n(&graph->events, __ATOMIC_SEQ_CST);
+		if (has_new_command(threadpool, command) || is_graph_claimed(graph) || find_ready_graph_node(graph) != NULL) {
+			break;
+		}
+		PTHREADPOOL_STATS_ADD(thread, futex_waits, 1);
+		pthreadpool_futex_wait(&graph->events, events);
+	}
+	__atomic_sub_fetch(&graph->waiters, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * Processes items of the ready nodes of the graph in the job argument. The items of the job are the nodes of the graph,
+ * and the thread which completes a node accounts for it.
+ */
+static size_t thread_run_graph(struct pthreadpool* threadpool, struct job* job, struct thread_info* thread) {
+	struct pthreadpool_graph* graph = (struct pthreadpool_graph*) job->argument;
+	/* A thread leaves the job when a new job is submitted, so that worker threads spread across the running jobs */
+	const uint32_t command = __atomic_load_n(&threadpool->command, __ATOMIC_RELAXED);
+	size_t completed_nodes = 0;
+	while (!has_new_command(threadpool, command)) {
+		struct graph_node* node = find_ready_graph_node(graph);
+		if (node != NULL) {
+			const size_t range = node->range;
+			const size_t grain = node->grain;
+			const size_t batch_start = __atomic_fetch_add(&node->claimed_items, grain, __ATOMIC_RELAXED);
+			if (batch_start < range) {
+				const size_t batch_size = min(grain, range - batch_start);
+				void* argument = node->has_context ? (void*) node->context : node->argument;
+				process_items_1d(thread, node->function, argument, false, false, NULL, batch_start, batch_size);
+				if (__atomic_sub_fetch(&node->remaining_items, batch_size, __ATOMIC_ACQ_REL) == 0) {
+					complete_graph_node(graph, node);
+					completed_nodes += 1;
+				}
+			}
+		} else if (is_graph_claimed(graph)) {
+			/* All items are taken: threads which look for work need not join this job anymore */
+			__atomic_store_n(&job->exhausted, 1, __ATOMIC_RELAXED);
+			break;
+		} else {
+			wait_for_ready_graph_node(threadpool, thread, graph, command);
+		}
+	}
+	return completed_nodes;
+}
+
+/*
+ * Predicate for wait_for_job_event: no thread accesses the completed job with the specified handle anymore.
+ * Threads which completed their part of a graph job may still access the graph until they leave the job.
+ */
+static bool is_job_handle_released(struct pthreadpool* threadpool, uint32_t handle) {
+	struct job* job = get_job_slot(threadpool, handle);
+	return __atomic_load_n(&job->submitted_handle, __ATOMIC_SEQ_CST) != handle ||
+		__atomic_load_n(&job->users, __ATOMIC_SEQ_CST) == 0;
+}
+
+/*
+ * Grows the array to hold at least one more element, doubling its capacity.
+ * Returns false if memory can't be allocated, in which case the array is unchanged.
+ */
+static bool grow_graph_array(void** array, size_t* capacity, size_t count, size_t element_size) {
+	if (count < *capacity) {
+		return true;
+	}
+	const size_t new_capacity = *capacity == 0 ? 8 : *capacity * 2;
+	void* new_array = pthreadpool_allocate(new_capacity * element_size);
+	if (new_array == NULL) {
+		return false;
+	}
+	if (count != 0) {
+		memcpy(new_array, *array, count * element_size);
+	}
+	pthreadpool_deallocate(*array);
+	*array = new_array;
+	*capacity = new_capacity;
+	return true;
+}
+
+/* Item processing function of the nodes without items, which complete as soon as their dependencies complete */
+static void skip_graph_item(void* argument, size_t item) {
+}
+
+static int add_graph_node(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t context_size,
+	size_t range,
+	size_t* node_id)
+{
+	if (!grow_graph_array((void**) &graph->nodes, &graph->nodes_capacity, graph->nodes_count, sizeof(struct graph_node))) {
+		return ENOMEM;
+	}
+	if (range == 0) {
+		/* A node completes when its last item is processed, so an empty node gets a dummy item */
+		function = skip_graph_item;
+		argument = NULL;
+		context_size = 0;
+		range = 1;
+	}
+
+	struct graph_node* node = &graph->nodes[graph->nodes_count];
+	memset(node, 0, sizeof(struct graph_node));
+	node->function = (void*) function;
+	node->argument = argument;
+	node->range = range;
+	if (context_size != 0) {
+		memcpy(node->context, argument, context_size);
+		node->argument = NULL;
+		node->has_context = 1;
+	}
+	*node_id = graph->nodes_count++;
+	return 0;
+}
+
+/*
+ * Groups the dependent nodes of every node in graph->dependents, if dependencies changed since the last run.
+ * Returns false if memory can't be allocated.
+ */
+static bool index_graph_dependents(struct pthreadpool_graph* graph) {
+	if (graph->has_dependents) {
+		return true;
+	}
+
+	struct graph_node* nodes = graph->nodes;
+	const size_t nodes_count = graph->nodes_count;
+	const struct graph_edge* edges = graph->edges;
+	const size_t edges_count = graph->edges_count;
+	size_t* dependents = NULL;
+	if (edges_count != 0) {
+		dependents = pthreadpool_allocate(edges_count * sizeof(size_t));
+		if (dependents == NULL) {
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < nodes_count; i++) {
+		nodes[i].dependents_count = 0;
+	}
+	for (size_t i = 0; i < edges_count; i++) {
+		nodes[edges[i].dependency].dependents_count += 1;
+	}
+	size_t dependents_start = 0;
+	for (size_t i = 0; i < nodes_count; i++) {
+		nodes[i].dependents_start = dependents_start;
+		dependents_start += nodes[i].dependents_count;
+		/* Counted again as the dependents are stored */
+		nodes[i].dependents_count = 0;
+	}
+	for (size_t i = 0; i < edges_count; i++) {
+		struct graph_node* node = &nodes[edges[i].dependency];
+		dependents[node->dependents_start + node->dependents_count++] = edges[i].dependent;
+	}
+
+	pthreadpool_deallocate(graph->dependents);
+	graph->dependents = dependents;
+	graph->has_dependents = 1;
+	return true;
+}
+
+struct pthreadpool_graph* pthreadpool_graph_create(void) {
+	struct pthreadpool_graph* graph = pthreadpool_allocate(sizeof(struct pthreadpool_graph));
+	if (graph != NULL) {
+		memset(graph, 0, sizeof(struct pthreadpool_graph));
+	}
+	return graph;
+}
+
+int pthreadpool_graph_add_1d(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t* node)
+{
+	return add_graph_node(graph, function, argument, 0, range, node);
+}
+
+int pthreadpool_graph_add_1d_tiled(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t* node)
+{
+	struct compute_1d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.range = range,
+		.tile = tile
+	};
+	return add_graph_node(graph, (pthreadpool_function_1d_t) compute_1d_tiled, &context, sizeof(context),
+		divide_round_up(range, tile), node);
+}
+
+int pthreadpool_graph_add_2d(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t* node)
+{
+	struct compute_2d_context context = {
+		.function = function,
+		.argument = argument,
+		.range_j = fxdiv_init_size_t(range_j == 0 ? 1 : range_j)
+	};
+	return add_graph_node(graph, (pthreadpool_function_1d_t) compute_2d, &context, sizeof(context),
+		range_i * range_j, node);
+}
+
+int pthreadpool_graph_add_2d_tiled(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t* node)
+{
+	const size_t tile_range_i = divide_round_up(range_i, tile_i);
+	const size_t tile_range_j = divide_round_up(range_j, tile_j);
+	struct compute_2d_tiled_context context = {
+		.function = function,
+		.argument = argument,
+		.tile_range_j = fxdiv_init_size_t(tile_range_j == 0 ? 1 : tile_range_j),
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j
+	};
+	return add_graph_node(graph, (pthreadpool_function_1d_t) compute_2d_tiled, &context, sizeof(context),
+		tile_range_i * tile_range_j, node);
+}
+
+int pthreadpool_graph_add_dependency(struct pthreadpool_graph* graph, size_t node, size_t dependency) {
+	if (node >= graph->nodes_count || dependency >= node) {
+		return EINVAL;
+	}
+	if (!grow_graph_array((void**) &graph->edges, &graph->edges_capacity, graph->edges_count, sizeof(struct graph_edge))) {
+		return ENOMEM;
+	}
+	graph->edges[graph->edges_count++] = (struct graph_edge) {
+		.dependency = dependency,
+		.dependent = node,
+	};
+	graph->nodes[node].dependencies_count += 1;
+	graph->has_dependents = 0;
+	return 0;
+}
+
+int pthreadpool_graph_run(struct pthreadpool* threadpool, struct pthreadpool_graph* graph) {
+	struct graph_node* nodes = graph->nodes;
+	const size_t nodes_count = graph->nodes_count;
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: the order of the nodes satisfies the dependencies */
+		for (size_t i = 0; i < nodes_count; i++) {
+			void* argument = nodes[i].has_context ? (void*) nodes[i].context : nodes[i].argument;
+			for (size_t j = 0; j < nodes[i].range; j++) {
+				((pthreadpool_function_1d_t) nodes[i].function)(argument, j);
+			}
+		}
+		return 0;
+	}
+	if (nodes_count == 0) {
+		return 0;
+	}
+	if (!index_graph_dependents(graph)) {
+		return ENOMEM;
+	}
+
+	/* Locking not needed: threads do not access the graph until they observe the job */
+	const size_t threads_count = get_enabled_threads_count(threadpool);
+	size_t items = 0;
+	for (size_t i = 0; i < nodes_count; i++) {
+		struct graph_node* node = &nodes[i];
+		items += node->range;
+		/* A node is often processed by all threads, as with the automatic grain size of a standalone loop */
+		node->grain = node->range / (threads_count * PTHREADPOOL_AUTO_GRAIN_BATCHES_PER_THREAD);
+		if (node->grain == 0) {
+			node->grain = 1;
+		}
+		node->claimed_items = 0;
+		node->remaining_items = node->range;
+		node->pending_dependencies = node->dependencies_count;
+	}
+	graph->first_unclaimed_node = 0;
+
+	/* Items of the job are nodes, but threads can share the items of a node */
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.parallelism = items,
+	};
+	const uint32_t handle = run_job(threadpool, thread_run_graph, NULL, graph, 0, nodes_count, &options, true);
+	/* The graph may be released as soon as this function returns */
+	wait_for_job_event(threadpool, is_job_handle_released, handle);
+	return 0;
+}
+
+void pthreadpool_graph_destroy(struct pthreadpool_graph* graph) {
+	if (graph != NULL) {
+		pthreadpool_deallocate(graph->dependents);
+		pthreadpool_deallocate(graph->edges);
+		pthreadpool_deallocate(graph->nodes);
+		pthreadpool_deallocate(graph);
+	}
+}
+
+/* Loop of a batch, which covers the items [items_start, items_end) of the batch */
+struct batch_loop {
+	pthreadpool_function_1d_t function;
+	void* argument;
+	size_t items_start;
+	size_t items_end;
+	union {
+		struct compute_1d_tiled_context compute_1d_tiled;
+		struct compute_2d_context compute_2d;
+		struct compute_2d_tiled_context compute_2d_tiled;
+	} context;
+};
+
+struct compute_batch_context {
+	size_t loops_count;
+	struct batch_loop loops[PTHREADPOOL_BATCH_MAX_LOOPS];
+};
+
+static void compute_batch(const struct compute_batch_context* context, size_t linear_index) {
+	/* Binary search for the loop which contains the item */
+	size_t first_loop = 0;
+	size_t last_loop = context->loops_count - 1;
+	while (first_loop != last_loop) {
+		const size_t middle_loop = (first_loop + last_loop) / 2;
+		if (linear_index < context->loops[middle_loop].items_end) {
+			last_loop = middle_loop;
+		} else {
+			first_loop = middle_loop + 1;
+		}
+	}
+	const struct batch_loop* loop = &context->loops[first_loop];
+	loop->function(loop->argument, linear_index - loop->items_start);
+}
+
+/* Sets up the adapter of the batch loop, and returns the number of items of the loop */
+static size_t init_batch_loop(struct batch_loop* batch_loop, const struct pthreadpool_loop* loop) {
+	switch (loop->type) {
+		case pthreadpool_loop_1d:
+			batch_loop->function = loop->function.function_1d;
+			batch_loop->argument = loop->argument;
+			return loop->range_i;
+		case pthreadpool_loop_1d_tiled:
+			batch_loop->context.compute_1d_tiled = (struct compute_1d_tiled_context) {
+				.function = loop->function.function_1d_tiled,
+				.argument = loop->argument,
+				.range = loop->range_i,
+				.tile = loop->tile_i
+			};
+			batch_loop->function = (pthreadpool_function_1d_t) compute_1d_tiled;
+			batch_loop->argument = &batch_loop->context;
+			return divide_round_up(loop->range_i, loop->tile_i);
+		case pthreadpool_loop_2d:
+			if (loop->range_j == 0) {
+				return 0;
+			}
+			batch_loop->context.compute_2d = (struct compute_2d_context) {
+				.function = loop->function.function_2d,
+				.argument = loop->argument,
+				.range_j = fxdiv_init_size_t(loop->range_j)
+			};
+			batch_loop->function = (pthreadpool_function_1d_t) compute_2d;
+			batch_loop->argument = &batch_loop->context;
+			return loop->range_i * loop->range_j;
+		case pthreadpool_loop_2d_tiled:
+		{
+			const size_t tile_range_i = divide_round_up(loop->range_i, loop->tile_i);
+			const size_t tile_range_j = divide_round_up(loop->range_j, loop->tile_j);
+			if (tile_range_j == 0) {
+				return 0;
+			}
+			batch_loop->context.compute_2d_tiled = (struct compute_2d_tiled_context) {
+				.function = loop->function.function_2d_tiled,
+				.argument = loop->argument,
+				.tile_range_j = fxdiv_init_size_t(tile_range_j),
+				.range_i = loop->range_i,
+				.range_j = loop->range_j,
+				.tile_i = loop->tile_i,
+				.tile_j = loop->tile_j
+			};
+			batch_loop->function = (pthreadpool_function_1d_t) compute_2d_tiled;
+			batch_loop->argument = &batch_loop->context;
+			return tile_range_i * tile_range_j;
+		}
+	}
+	return 0;
+}
+
+void pthreadpool_compute_batch(
+	struct pthreadpool* threadpool,
+	const struct pthreadpool_loop* loops,
+	size_t loops_count)
+{
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: process the loops one after another on the calling thread */
+		for (size_t i = 0; i < loops_count; i++) {
+			const struct pthreadpool_loop* loop = &loops[i];
+			switch (loop->type) {
+				case pthreadpool_loop_1d:
+					pthreadpool_compute_1d(NULL, loop->function.function_1d, loop->argument, loop->range_i);
+					break;
+				case pthreadpool_loop_1d_tiled:
+					pthreadpool_compute_1d_tiled(NULL, loop->function.function_1d_tiled, loop->argument,
+						loop->range_i, loop->tile_i);
+					break;
+				case pthreadpool_loop_2d:
+					pthreadpool_compute_2d(NULL, loop->function.function_2d, loop->argument,
+						loop->range_i, loop->range_j);
+					break;
+				case pthreadpool_loop_2d_tiled:
+					pthreadpool_compute_2d_tiled(NULL, loop->function.function_2d_tiled, loop->argument,
+						loop->range_i, loop->range_j, loop->tile_i, loop->tile_j);
+					break;
+			}
+		}
+		return;
+	}
+
+	/* Each group of loops runs as a single job over the concatenated items of the loops */
+	struct compute_batch_context context;
+	for (size_t group_start = 0; group_start < loops_count; group_start += PTHREADPOOL_BATCH_MAX_LOOPS) {
+		const size_t group_end = min(group_start + PTHREADPOOL_BATCH_MAX_LOOPS, loops_count);
+		size_t items = 0;
+		context.loops_count = 0;
+		for (size_t i = group_start; i < group_end; i++) {
+			struct batch_loop* batch_loop = &context.loops[context.loops_count];
+			const size_t range = init_batch_loop(batch_loop, &loops[i]);
+			if (range != 0) {
+				batch_loop->items_start = items;
+				items += range;
+				batch_loop->items_end = items;
+				context.loops_count += 1;
+			}
+		}
+		run_job(threadpool, thread_compute_1d, (void*) compute_batch, &context, 0, items, &default_job_options, true);
+	}
+}
+
+/* Splits the items of the plan between threads_count threads, as submit_job does for synchronous jobs */
+static void partition_plan(struct pthreadpool_plan* plan, size_t threads_count) {
+	/* Synchronous jobs spread the items over all threads: thread 0 is either the calling thread, or a dedicated worker */
+	struct job_partition* partition = plan->partition;
+	for (size_t tid = 0; tid <= threads_count; tid++) {
+		partition->boundaries[tid] = get_segment_start(plan->range, tid, 0, threads_count);
+	}
+	partition->threads_count = threads_count;
+}
+
+/*
+ * Creates a plan which calls the function for each of range items. If context_size is non-zero, the function is an
+ * adapter, and the context is copied into the plan; argument_offset locates the argument field in the context.
+ */
+static struct pthreadpool_plan* create_plan(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	const void* context,
+	size_t context_size,
+	size_t argument_offset,
+	size_t range)
+{
+	/* The partition has room for any number of enabled threads */
+	const size_t max_threads_count = threadpool == NULL ? 1 : threadpool->threads_count;
+	struct pthreadpool_plan* plan = pthreadpool_allocate(sizeof(struct pthreadpool_plan) +
+		sizeof(struct job_partition) + (max_threads_count + 1) * sizeof(size_t));
+	if (plan == NULL) {
+		return NULL;
+	}
+	plan->threadpool = threadpool;
+	plan->function = (void*) function;
+	plan->context_argument = NULL;
+	plan->range = range;
+	if (context_size != 0) {
+		memcpy(plan->context, context, context_size);
+		plan->context_argument = (void**) ((char*) plan->context + argument_offset);
+	}
+	plan->partition = (struct job_partition*) (plan + 1);
+	partition_plan(plan, threadpool == NULL ? 1 : get_enabled_threads_count(threadpool));
+	return plan;
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	size_t range)
+{
+	return create_plan(threadpool, function, NULL, 0, 0, range);
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_1d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	size_t range,
+	size_t tile)
+{
+	const struct compute_1d_tiled_context context = {
+		.function = function,
+		.range = range,
+		.tile = tile
+	};
+	return create_plan(threadpool, (pthreadpool_function_1d_t) compute_1d_tiled, &context, sizeof(context),
+		offsetof(struct compute_1d_tiled_context, argument), divide_round_up(range, tile));
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	size_t range_i,
+	size_t range_j)
+{
+	const struct compute_2d_context context = {
+		.function = function,
+		.range_j = fxdiv_init_size_t(range_j == 0 ? 1 : range_j)
+	};
+	return create_plan(threadpool, (pthreadpool_function_1d_t) compute_2d, &context, sizeof(context),
+		offsetof(struct compute_2d_context, argument), range_i * range_j);
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_2d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	const size_t tile_range_i = divide_round_up(range_i, tile_i);
+	const size_t tile_range_j = divide_round_up(range_j, tile_j);
+	const struct compute_2d_tiled_context context = {
+		.function = function,
+		.tile_range_j = fxdiv_init_size_t(tile_range_j == 0 ? 1 : tile_range_j),
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j
+	};
+	return create_plan(threadpool, (pthreadpool_function_1d_t) compute_2d_tiled, &context, sizeof(context),
+		offsetof(struct compute_2d_tiled_context, argument), tile_range_i * tile_range_j);
+}
+
+void pthreadpool_plan_execute(struct pthreadpool_plan* plan, void* argument) {
+	void* job_argument = argument;
+	if (plan->context_argument != NULL) {
+		*plan->context_argument = argument;
+		job_argument = plan->context;
+	}
+
+	struct pthreadpool* threadpool = plan->threadpool;
+	const size_t range = plan->range;
+	if (is_sequential_call(threadpool)) {
+		/* No thread pool used: execute function sequentially on the calling thread */
+		for (size_t i = 0; i < range; i++) {
+			((pthreadpool_function_1d_t) plan->function)(job_argument, i);
+		}
+		return;
+	}
+
+	const size_t threads_count = get_enabled_threads_count(threadpool);
+	if (plan->partition->threads_count != threads_count) {
+		partition_plan(plan, threads_count);
+	}
+	const struct job_options options = {
+		.max_threads_count = SIZE_MAX,
+		.grain = 1,
+		.flags = 0,
+		.partition = plan->partition,
+	};
+	/* The plan outlives the job, so the context is not copied */
+	run_job(threadpool, thread_compute_1d, plan->function, job_argument, 0, range, &options, true);
+}
+
+void pthreadpool_plan_destroy(struct pthreadpool_plan* plan) {
+	pthreadpool_deallocate(plan);
+}
+
+void pthreadpool_destroy(struct pthreadpool* threadpool) {
+	/* The default thread pool lives until the process exits */
+	if (threadpool != NULL && threadpool != __atomic_load_n(&default_threadpool, __ATOMIC_RELAXED)) {
+		/* Wait for completion of the submitted jobs, and until no thread accesses their slots */
+		wait_for_job_event(threadpool, are_job_slots_free, 0);
+
+		if (threadpool->started_threads_end != threadpool->workers_start) {
+			/* Unpark the worker threads to let them receive the shutdown command */
+			enable_threads(threadpool, threadpool->threads_count);
+			shutdown_worker_threads(threadpool, threadpool->started_threads_end);
+		}
+
+		/* Release resources */
+		for (size_t tid = 0; tid < threadpool->threads_count; tid++) {
+			pthreadpool_deallocate(threadpool->threads[tid].scratch);
+		}
+		pthreadpool_mutex_destroy(&threadpool->execution_mutex);
+		pthreadpool_mutex_destroy(&threadpool->scratch_mutex);
+		pthreadpool_deallocate(threadpool);
+	}
+}
@@ -0,0 +1,201 @@
+/* Standard C headers */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* MiniOS headers */
+#include <mini-os/os.h>
+#include <mini-os/sched.h>
+#include <mini-os/semaphore.h>
+#include <mini-os/time.h>
+#include <mini-os/wait.h>
+#include <mini-os/xmalloc.h>
+
+/* Internal headers */
+#include "threadpool-object.h"
+#include "threadpool-utils.h"
+
+
+/*
+ * MiniOS has no futex, but its wait queues give the same guarantee: a thread which is added to a wait queue
+ * and marked blocked before it checks the value is made runnable again by any wake_up that comes after the check.
+ * Addresses are hashed into a small set of wait queues; threads waiting on different addresses in the same
+ * queue are woken up spuriously and go back to sleep after re-checking the value.
+ */
+#define PTHREADPOOL_FUTEX_BUCKETS 16
+
+static struct wait_queue_head futex_wait_queues[PTHREADPOOL_FUTEX_BUCKETS];
+static bool futex_wait_queues_initialized = false;
+
+static struct wait_queue_head* futex_get_wait_queue(uint32_t* address) {
+	return &futex_wait_queues[((uintptr_t) address / sizeof(uint32_t)) % PTHREADPOOL_FUTEX_BUCKETS];
+}
+
+/* Waits on the address until woken up, or until the deadline in NOW() time if it is not 0 */
+static void futex_wait(uint32_t* address, uint32_t value, s_time_t deadline) {
+	struct wait_queue_head* wait_queue = futex_get_wait_queue(address);
+	DEFINE_WAIT(waiter);
+
+	/* Enqueue and mark the thread blocked before checking the value to not miss a wake-up in between */
+	add_waiter(waiter, *wait_queue);
+	/* The scheduler makes a blocked thread runnable again at its wake-up time, unless it is 0 */
+	get_current()->wakeup_time = deadline;
+	if (__atomic_load_n(address, __ATOMIC_ACQUIRE) == value) {
+		schedule();
+	}
+	/* The thread might still be marked blocked if the value changed before it slept */
+	wake(get_current());
+	remove_waiter(waiter, *wait_queue);
+}
+
+static void futex_wake_all(uint32_t* address) {
+	wake_up(futex_get_wait_queue(address));
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wait(uint32_t* address, uint32_t value) {
+	futex_wait(address, value, 0);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wait_timeout(uint32_t* address, uint32_t value, uint64_t timeout_ns) {
+	futex_wait(address, value, NOW() + (s_time_t) timeout_ns);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wake_all(uint32_t* address) {
+	futex_wake_all(address);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wake(uint32_t* address, uint32_t count) {
+	/* Wait queues are shared between addresses, and only waking up all waiters reaches those on the address */
+	futex_wake_all(address);
+}
+
+/*
+ * MiniOS schedules all threads of the domain on its boot vCPU, whatever the number of vCPUs of the domain, and never
+ * preempts them. Worker threads then only interleave with the calling thread, and can't process items in parallel:
+ * thread pools default to a single thread, which computes everything on the calling thread. Pools with more threads
+ * work, but only overlap items which block.
+ */
+PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors_count(void) {
+	return 1;
+}
+
+PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors(struct pthreadpool_processor* processors, size_t max_processors) {
+	if (max_processors == 0) {
+		return 0;
+	}
+	processors[0] = (struct pthreadpool_processor) {
+		.id = 0,
+		.core = 0,
+		.node = 0,
+	};
+	return 1;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_bind_current_thread(uint32_t processor) {
+	/* MiniOS schedules all threads of the domain on its boot vCPU, so every thread is already bound to it */
+}
+
+/*
+ * MiniOS has no thread-local storage: the thread pool which a thread processes jobs of is recorded in a list searched
+ * by the thread. Records are allocated on first use, and are reused by other threads once released. MiniOS threads
+ * are not preempted, so the list needs no locking.
+ */
+struct current_threadpool_record {
+	struct thread* thread;
+	struct pthreadpool* threadpool;
+	struct current_threadpool_record* next;
+};
+
+static struct current_threadpool_record* current_threadpool_records = NULL;
+
+PTHREADPOOL_INTERNAL struct pthreadpool* pthreadpool_get_current_threadpool(void) {
+	struct thread* thread = get_current();
+	for (struct current_threadpool_record* record = current_threadpool_records; record != NULL; record = record->next) {
+		if (record->thread == thread) {
+			return record->threadpool;
+		}
+	}
+	return NULL;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_set_current_threadpool(struct pthreadpool* threadpool) {
+	struct thread* thread = get_current();
+	struct current_threadpool_record* free_record = NULL;
+	for (struct current_threadpool_record* record = current_threadpool_records; record != NULL; record = record->next) {
+		if (record->thread == thread) {
+			/* Release the record when the thread stops processing jobs */
+			record->thread = threadpool != NULL ? thread : NULL;
+			record->threadpool = threadpool;
+			return;
+		}
+		if (record->thread == NULL && free_record == NULL) {
+			free_record = record;
+		}
+	}
+	if (threadpool == NULL) {
+		return;
+	}
+	if (free_record == NULL) {
+		free_record = _xmalloc(sizeof(struct current_threadpool_record), sizeof(void*));
+		if (free_record == NULL) {
+			/* Calls from this thread are not recognized as nested */
+			return;
+		}
+		free_record->next = current_threadpool_records;
+		current_threadpool_records = free_record;
+	}
+	free_record->thread = thread;
+	free_record->threadpool = threadpool;
+}
+
+PTHREADPOOL_INTERNAL uint64_t pthreadpool_get_time_ns(void) {
+	return (uint64_t) NOW();
+}
+
+PTHREADPOOL_INTERNAL void* pthreadpool_allocate(size_t size) {
+	/* Wait queues are initialized lazily, but before any pool (and thus any worker thread) exists */
+	if (!futex_wait_queues_initialized) {
+		for (size_t i = 0; i < PTHREADPOOL_FUTEX_BUCKETS; i++) {
+			init_waitqueue_head(&futex_wait_queues[i]);
+		}
+		futex_wait_queues_initialized = true;
+	}
+	return _xmalloc(size, PTHREADPOOL_CACHELINE_SIZE);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_deallocate(void* pointer) {
+	xfree(pointer);
+}
+
+static void thread_main(void* arg) {
+	pthreadpool_thread_main((struct thread_info*) arg);
+	/* Returning from the thread function makes MiniOS call exit_thread() and reclaim the stack */
+}
+
+PTHREADPOOL_INTERNAL bool pthreadpool_start_thread(struct thread_info* thread) {
+	thread->thread_object = create_thread("pthreadpool", thread_main, thread);
+	return thread->thread_object != NULL;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_join_thread(struct thread_info* thread) {
+	/*
+	 * MiniOS threads can't be joined. Workers check in after their last access to the thread pool
+	 * and exit right after, so waiting for the check-in (done by the caller) is sufficient.
+	 */
+	thread->thread_object = NULL;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_init(pthreadpool_mutex_t* mutex) {
+	init_SEMAPHORE(mutex, 1);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_lock(pthreadpool_mutex_t* mutex) {
+	down(mutex);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_unlock(pthreadpool_mutex_t* mutex) {
+	up(mutex);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_destroy(pthreadpool_mutex_t* mutex) {
+	/* MiniOS semaphores hold no resources */
+}
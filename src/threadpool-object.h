@@ -0,0 +1,652 @@
+#pragma once
+
+/* Standard C headers */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Platform-specific headers */
+#if defined(__MINIOS__)
+	#include <mini-os/os.h>
+	#include <mini-os/sched.h>
+	#include <mini-os/semaphore.h>
+#else
+	#include <pthread.h>
+#endif
+
+/* Library header */
+#include <pthreadpool.h>
+
+/* Internal headers */
+#include "threadpool-utils.h"
+
+#if defined(__MINIOS__)
+	typedef struct thread* pthreadpool_thread_t;
+	typedef struct semaphore pthreadpool_mutex_t;
+#else
+	typedef pthread_t pthreadpool_thread_t;
+	typedef pthread_mutex_t pthreadpool_mutex_t;
+#endif
+
+/*
+ * Default number of iterations to spin-wait for a new command or for command completion before sleeping on a futex.
+ * MiniOS scheduler is not preemptive, and a spinning thread would only delay the threads it waits for.
+ */
+#if defined(__MINIOS__)
+	#define PTHREADPOOL_SPIN_WAIT_ITERATIONS 0
+#else
+	#define PTHREADPOOL_SPIN_WAIT_ITERATIONS 10000
+#endif
+
+/*
+ * Collection of per-thread statistics for pthreadpool_get_stats, enabled with the PTHREADPOOL_ENABLE_STATS build option.
+ * When disabled, the statistics macros compile to nothing, and do not evaluate their arguments.
+ */
+#ifndef PTHREADPOOL_ENABLE_STATS
+	#define PTHREADPOOL_ENABLE_STATS 0
+#endif
+
+#if PTHREADPOOL_ENABLE_STATS
+	/* Adds the value to the counter in the statistics of the thread */
+	#define PTHREADPOOL_STATS_ADD(thread, counter, value) \
+		((void) __atomic_fetch_add(&(thread)->stats.counter, (uint64_t) (value), __ATOMIC_RELAXED))
+	/* Returns a timestamp for the busy_ns and idle_ns counters */
+	#define PTHREADPOOL_STATS_TIMESTAMP() pthreadpool_get_time_ns()
+#else
+	#define PTHREADPOOL_STATS_ADD(thread, counter, value) ((void) sizeof(value))
+	#define PTHREADPOOL_STATS_TIMESTAMP() UINT64_C(0)
+#endif
+
+/*
+ * Recording of a trace of the work of threads for pthreadpool_get_trace, enabled with the PTHREADPOOL_ENABLE_TRACE
+ * build option. When disabled, the tracing macros compile to nothing, and do not evaluate their arguments.
+ */
+#ifndef PTHREADPOOL_ENABLE_TRACE
+	#define PTHREADPOOL_ENABLE_TRACE 0
+#endif
+
+/* The number of the latest trace events of each thread which the thread pool keeps, a power of 2 */
+#define PTHREADPOOL_TRACE_EVENTS 4096
+
+#if PTHREADPOOL_ENABLE_TRACE
+	/* Returns a timestamp for the trace events */
+	#define PTHREADPOOL_TRACE_TIMESTAMP() pthreadpool_get_time_ns()
+	/* Records a trace event of the specified type in the ring buffer of the thread */
+	#define PTHREADPOOL_TRACE_EVENT(thread, type, value, start_ns, end_ns, range_start, range_length) \
+		record_trace_event((thread), (type), (value), (start_ns), (end_ns), (range_start), (range_length))
+#else
+	#define PTHREADPOOL_TRACE_TIMESTAMP() UINT64_C(0)
+	#define PTHREADPOOL_TRACE_EVENT(thread, type, value, start_ns, end_ns, range_start, range_length) \
+		((void) sizeof((value) + (start_ns) + (end_ns) + (range_start) + (range_length)))
+#endif
+
+/* Value of thread_info.processor for threads which are not bound to a processor */
+#define PTHREADPOOL_NO_PROCESSOR UINT32_MAX
+
+/* The number of jobs which can run or wait in a thread pool at the same time; further submissions block */
+#define PTHREADPOOL_JOB_QUEUE_SIZE 16
+
+/* The number of job slots which only high-priority jobs take, so that they do not wait for normal-priority jobs */
+#define PTHREADPOOL_HIGH_PRIORITY_JOB_SLOTS 4
+
+/* With automatic grain size, the number of batches of items to split the initial segment of each thread into */
+#define PTHREADPOOL_AUTO_GRAIN_BATCHES_PER_THREAD 32
+
+/* The number of loops which pthreadpool_compute_batch dispatches with a single job */
+#define PTHREADPOOL_BATCH_MAX_LOOPS 16
+
+/* Maximum size of the adapter context copied into a job slot by pthreadpool_submit_* functions */
+#define PTHREADPOOL_JOB_CONTEXT_SIZE 256
+
+/*
+ * The command word consists of the command in the low bits, and a counter of submitted commands in the high bits.
+ * Worker threads monitor for change in the whole command word, which changes with every submitted job.
+ */
+#define THREADPOOL_COMMAND_MASK UINT32_C(0x00000003)
+
+enum threadpool_command {
+	threadpool_command_init,
+	threadpool_command_compute_1d,
+	threadpool_command_shutdown,
+};
+
+enum trace_event_type {
+	/* A thread processed items of a job. The event value is the job handle. */
+	trace_event_job,
+	/* A thread processed a range of items from its own segment. The event value is the thread number. */
+	trace_event_items,
+	/* A thread processed a range of items stolen from the segment of another thread, whose number is the event value. */
+	trace_event_steal,
+};
+
+/*
+ * A record in the trace ring buffer of a thread. Records are written and read with relaxed atomic operations,
+ * and the sequence number detects records which are overwritten while they are read.
+ */
+struct trace_event {
+	/**
+	 * Odd while the record is written, and 2 * (position + 1) for a complete record at the specified position
+	 * in the sequence of trace events of the thread.
+	 */
+	uint64_t sequence;
+	/**
+	 * The time the event started, in nanoseconds, as returned by pthreadpool_get_time_ns.
+	 */
+	uint64_t start_ns;
+	/**
+	 * The time the event ended, in nanoseconds, as returned by pthreadpool_get_time_ns.
+	 */
+	uint64_t end_ns;
+	/**
+	 * The first item processed during the event.
+	 */
+	uint64_t range_start;
+	/**
+	 * The number of items processed during the event.
+	 */
+	uint64_t range_length;
+	/**
+	 * The type of the event, one of the trace_event_type values.
+	 */
+	uint32_t type;
+	/**
+	 * The value associated with the event, which depends on the event type.
+	 */
+	uint32_t value;
+};
+
+struct PTHREADPOOL_CACHELINE_ALIGNED thread_info {
+	/**
+	 * Thread number in the 0..threads_count-1 range.
+	 */
+	size_t thread_number;
+	/**
+	 * The platform thread object corresponding to the thread.
+	 */
+	pthreadpool_thread_t thread_object;
+	/**
+	 * Cache line-aligned scratch memory private to the thread, or NULL if not allocated yet.
+	 * Grown on demand (see @a pthreadpool_compute_2d_tiled_with_scratch) while no job uses it.
+	 */
+	void* scratch;
+	/**
+	 * The size of @a scratch memory, in bytes.
+	 */
+	size_t scratch_size;
+	/**
+	 * The first thread in the group of threads bound to the same NUMA node as this thread.
+	 * The group occupies consecutive thread numbers, and threads steal work within the group first.
+	 */
+	size_t numa_group_start;
+	/**
+	 * The thread after the last thread in the group of threads bound to the same NUMA node as this thread.
+	 */
+	size_t numa_group_end;
+	/**
+	 * The processor the thread is bound to, or PTHREADPOOL_NO_PROCESSOR if the thread is not bound.
+	 */
+	uint32_t processor;
+#if PTHREADPOOL_ENABLE_STATS
+	/**
+	 * Statistics of the thread. Updated with relaxed atomic additions: callers which process jobs as thread 0
+	 * may update the statistics of thread 0 concurrently.
+	 */
+	struct pthreadpool_thread_stats stats;
+#endif
+#if PTHREADPOOL_ENABLE_TRACE
+	/**
+	 * Ring buffer of the PTHREADPOOL_TRACE_EVENTS latest trace events of the thread, allocated with the thread pool.
+	 */
+	struct trace_event* trace_events;
+	/**
+	 * The number of trace events ever recorded by the thread. Callers which process jobs as thread 0 may record
+	 * trace events of thread 0 concurrently, and reserve records with atomic increments of this counter.
+	 */
+	uint64_t trace_events_count;
+#endif
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct thread_info) % PTHREADPOOL_CACHELINE_SIZE == 0, "thread_info structure must occupy an integer number of cache lines (64 bytes)");
+
+/* Part of the items of a job, initially assigned to the thread with the same number */
+struct PTHREADPOOL_CACHELINE_ALIGNED job_segment {
+	/**
+	 * Index of the first element in the work range.
+	 * Before processing a new element the owning thread increments this value.
+	 */
+	size_t range_start;
+	/**
+	 * Index of the element after the last element of the work range.
+	 * Before processing a new element the stealing thread decrements this value.
+	 */
+	size_t range_end;
+	/**
+	 * The number of elements in the work range.
+	 * Due to race conditions range_length <= range_end - range_start.
+	 * The owning thread must decrement this value before incrementing @a range_start.
+	 * The stealing thread must decrement this value before decrementing @a range_end.
+	 *
+	 * All three range variables are accessed only through atomic operations (see @a atomic_decrement).
+	 * Threads claim batches of up to job::grain items, decrementing @a range_length by the batch size.
+	 * The initial values are published to other threads by the release store to @a job::submitted_handle.
+	 */
+	size_t range_length;
+};
+
+PTHREADPOOL_STATIC_ASSERT(sizeof(struct job_segment) == PTHREADPOOL_CACHELINE_SIZE, "job_segment structure must occupy exactly one cache line (64 bytes)");
+
+struct pthreadpool;
+struct job;
+
+/*
+ * Processes the items of a job on behalf of the specified thread: first the thread's own segment,
+ * then segments stolen from other threads. Returns the number of items processed.
+ * Sets job->exhausted when it observes that all items are taken. Returns early, without setting it,
+ * if a new job is submitted to the thread pool, to let worker threads redistribute among running jobs.
+ */
+typedef size_t (*thread_function_t)(struct pthreadpool* threadpool, struct job* job, struct thread_info* thread);
+
+/*
+ * Parallel loop submitted to a thread pool. Jobs run concurrently, sharing the worker threads.
+ *
+ * A job slot is busy from submission until the job completes and no thread uses the slot.
+ * Every submission to a slot advances its handle by PTHREADPOOL_JOB_QUEUE_SIZE, so that handles identify
+ * both the slot and the submission, and the job with handle H completed if completed_handle is not behind H.
+ */
+struct PTHREADPOOL_CACHELINE_ALIGNED job {
+	/**
+	 * The handle of the last job submitted to the slot.
+	 * Updated with release semantics after the job parameters.
+	 */
+	uint32_t submitted_handle;
+	/**
+	 * The handle of the last job completed in the slot.
+	 * The job is running if completed_handle != submitted_handle.
+	 */
+	uint32_t completed_handle;
+	/**
+	 * Indicates that all items of the running job were taken by threads, and there is no point to join the job.
+	 */
+	uint32_t exhausted;
+	/**
+	 * The number of threads which joined the job and may access the job slot.
+	 * The slot can be reused only after this value drops to zero.
+	 */
+	uint32_t users;
+	/**
+	 * The number of items which are not processed yet.
+	 * The thread which brings this value to zero completes the job.
+	 */
+	size_t remaining_items;
+	/**
+	 * The function which threads call to process the job.
+	 */
+	thread_function_t thread_function;
+	/**
+	 * The function to call for each item.
+	 */
+	void* function;
+	/**
+	 * The first argument to the item processing function.
+	 * Points either to the caller's argument, or to the copy of the adapter context in @a context.
+	 */
+	void* argument;
+	/**
+	 * Work segments of the job, one for each thread in the thread pool.
+	 */
+	struct job_segment* segments;
+	/**
+	 * The maximum number of items which a thread claims from a segment with one atomic update.
+	 */
+	size_t grain;
+	/**
+	 * Indicates that threads claim half of the remaining items of a segment at once, if this is more than @a grain.
+	 */
+	uint32_t guided;
+	/**
+	 * Indicates that the job was submitted with PTHREADPOOL_FLAG_PRIORITY_HIGH. Worker threads which look for work
+	 * join running high-priority jobs first, and join normal-priority jobs only when all items of those are taken.
+	 */
+	uint32_t high_priority;
+	/**
+	 * Set to non-zero by pthreadpool_cancel to cancel the job, unless @a cancellation points elsewhere.
+	 */
+	uint32_t cancelled;
+	/**
+	 * The flag which cancels the job when set to non-zero: either @a cancelled, or a flag of the synchronous call
+	 * which submitted the job. Threads take items which are left in a cancelled job without processing them.
+	 * The flag of a synchronous call may be accessed only by threads which took items and did not account for them,
+	 * since the call may return as soon as the job completes.
+	 */
+	uint32_t* cancellation;
+	/**
+	 * The number of threads which process the job: only segments with numbers below this value are used.
+	 * Threads with higher numbers must not join the job.
+	 */
+	size_t threads_count;
+	/**
+	 * Storage for the context of adapter functions, which must outlive the pthreadpool_submit_* call.
+	 */
+	uint64_t context[PTHREADPOOL_JOB_CONTEXT_SIZE / sizeof(uint64_t)];
+};
+
+/* Precomputed initial segments of the items of a job */
+struct job_partition {
+	/**
+	 * The number of threads which process the job.
+	 */
+	size_t threads_count;
+	/**
+	 * Thread tid initially processes the items [boundaries[tid], boundaries[tid + 1]).
+	 * Holds threads_count + 1 elements.
+	 */
+	size_t boundaries[];
+};
+
+/* Parallel loop with precomputed parameters, see @a pthreadpool_plan_execute */
+struct PTHREADPOOL_CACHELINE_ALIGNED pthreadpool_plan {
+	/**
+	 * The thread pool which executes the plan, or NULL if the plan is executed on the calling thread.
+	 */
+	struct pthreadpool* threadpool;
+	/**
+	 * The function to call for each item.
+	 */
+	void* function;
+	/**
+	 * The argument field of the adapter context in @a context, or NULL if the plan calls the function directly.
+	 */
+	void** context_argument;
+	/**
+	 * The number of items to process.
+	 */
+	size_t range;
+	/**
+	 * Initial segments of the threads, recomputed when the number of enabled threads changes.
+	 * Has room for the thread pool capacity, and immediately follows this structure.
+	 */
+	struct job_partition* partition;
+	/**
+	 * Storage for the context of adapter functions.
+	 */
+	uint64_t context[PTHREADPOOL_JOB_CONTEXT_SIZE / sizeof(uint64_t)];
+};
+
+/* Parallel loop in a graph of loops, see @a pthreadpool_graph_run */
+struct PTHREADPOOL_CACHELINE_ALIGNED graph_node {
+	/**
+	 * The number of items claimed by threads in the current run of the graph.
+	 * Threads claim batches of @a grain items by incrementing this value, which may overshoot @a range.
+	 */
+	size_t claimed_items;
+	/**
+	 * The number of items which are not processed yet in the current run of the graph.
+	 * The thread which brings this value to zero completes the node.
+	 */
+	size_t remaining_items;
+	/**
+	 * The number of nodes which this node depends on and which are not completed yet in the current run of the graph.
+	 * Threads claim items of the node only after this value drops to zero.
+	 */
+	size_t pending_dependencies;
+	/**
+	 * The function to call for each item. Parameters below are not modified while the graph runs.
+	 */
+	void* function PTHREADPOOL_CACHELINE_ALIGNED;
+	/**
+	 * The first argument to the item processing function, unless @a has_context is set.
+	 */
+	void* argument;
+	/**
+	 * Indicates that the first argument to the item processing function is the adapter context in @a context.
+	 * The context is not referenced by pointer, since the nodes move when the graph grows.
+	 */
+	uint32_t has_context;
+	/**
+	 * The number of items to process.
+	 */
+	size_t range;
+	/**
+	 * The maximum number of items which a thread claims with one atomic update, updated before every run.
+	 */
+	size_t grain;
+	/**
+	 * The number of nodes which this node depends on.
+	 */
+	size_t dependencies_count;
+	/**
+	 * The position of the first node which depends on this node in the pthreadpool_graph::dependents array.
+	 */
+	size_t dependents_start;
+	/**
+	 * The number of nodes which depend on this node.
+	 */
+	size_t dependents_count;
+	/**
+	 * Storage for the context of adapter functions.
+	 */
+	uint64_t context[PTHREADPOOL_JOB_CONTEXT_SIZE / sizeof(uint64_t)];
+};
+
+/* Dependency of a graph node on an earlier node */
+struct graph_edge {
+	size_t dependency;
+	size_t dependent;
+};
+
+struct PTHREADPOOL_CACHELINE_ALIGNED pthreadpool_graph {
+	/**
+	 * Nodes in the order they were added, which is also an order which satisfies the dependencies.
+	 */
+	struct graph_node* nodes;
+	size_t nodes_count;
+	size_t nodes_capacity;
+	/**
+	 * Dependencies in the order they were added.
+	 */
+	struct graph_edge* edges;
+	size_t edges_count;
+	size_t edges_capacity;
+	/**
+	 * Dependent nodes of every node, grouped by the node they depend on (see graph_node::dependents_start).
+	 * Built from @a edges by the first run after dependencies change.
+	 */
+	size_t* dependents;
+	/**
+	 * Indicates that @a dependents and graph_node::dependents_start/dependents_count reflect all @a edges.
+	 */
+	uint32_t has_dependents;
+	/**
+	 * All nodes before this one are completely claimed in the current run of the graph.
+	 * Only grows while the graph runs, and lets threads skip the claimed nodes when they look for work.
+	 */
+	size_t first_unclaimed_node;
+	/**
+	 * Counter of node completions in the graph. Threads waiting for ready nodes sleep on this futex.
+	 */
+	uint32_t events;
+	/**
+	 * The number of threads sleeping on a futex until @a events changes.
+	 */
+	uint32_t waiters;
+};
+
+struct PTHREADPOOL_CACHELINE_ALIGNED pthreadpool {
+	/**
+	 * The number of worker threads that are starting or shutting down.
+	 */
+	size_t active_threads;
+	/**
+	 * Indicates if there are active threads.
+	 * Only two values are possible:
+	 * - has_active_threads == 0 if active_threads == 0
+	 * - has_active_threads == 1 if active_threads != 0
+	 */
+	uint32_t has_active_threads;
+	/**
+	 * The number of threads sleeping on a futex until @a has_active_threads becomes zero.
+	 * The last worker thread to check in skips the futex wake-up if there are no such threads.
+	 */
+	uint32_t completion_waiters;
+	/**
+	 * The last command submitted to the thread pool.
+	 * Updated with release semantics after the command parameters, and read by worker threads with acquire semantics.
+	 */
+	uint32_t command;
+	/**
+	 * The number of worker threads sleeping on a futex until @a command changes.
+	 * The submitting thread skips the futex wake-up if there are no such threads.
+	 */
+	uint32_t command_waiters;
+	/**
+	 * The number of iterations to spin-wait before sleeping on a futex. Zero disables spinning.
+	 */
+	uint32_t spin_wait_iterations;
+	/**
+	 * Counter of job completions and job slot releases. Threads waiting for either event sleep on this futex.
+	 */
+	uint32_t job_events;
+	/**
+	 * The number of threads sleeping on a futex until @a job_events changes.
+	 * Threads which complete jobs and release job slots skip the futex wake-up if there are no such threads.
+	 */
+	uint32_t job_waiters;
+	/**
+	 * Counter of wake-ups of hibernating worker threads. Hibernating worker threads sleep on this futex.
+	 */
+	uint32_t hibernation_events;
+	/**
+	 * The number of worker threads which hibernate until @a hibernation_events changes.
+	 * Commands which need more worker threads than the other ones wake up hibernating worker threads.
+	 */
+	uint32_t hibernating_threads;
+	/**
+	 * The time an idle worker thread sleeps waiting for a new command before it hibernates, in nanoseconds.
+	 * UINT64_MAX disables hibernation.
+	 */
+	uint64_t hibernation_delay_ns;
+	/**
+	 * The number of worker threads, starting from @a workers_start, which never hibernate.
+	 */
+	size_t warm_threads_count;
+	/**
+	 * Serializes submission of jobs from different threads.
+	 */
+	pthreadpool_mutex_t execution_mutex;
+	/**
+	 * Serializes calls which use the scratch memory of threads.
+	 */
+	pthreadpool_mutex_t scratch_mutex;
+	/**
+	 * Job slots. Jobs which are submitted and not completed run concurrently.
+	 */
+	struct job jobs[PTHREADPOOL_JOB_QUEUE_SIZE];
+	/**
+	 * The number of threads in the thread pool, including thread 0 if it is the calling thread.
+	 * Never changes after initialization.
+	 */
+	size_t threads_count;
+	/**
+	 * The number of threads which process new jobs, between 1 and @a threads_count.
+	 * Worker threads with thread numbers above this value are parked on a futex until it grows.
+	 */
+	uint32_t enabled_threads_count;
+	/**
+	 * Thread number of the first worker thread. Worker threads have numbers in the [workers_start, threads_count) range.
+	 * Normally 1: the thread which runs a job synchronously processes it as thread 0 together with the worker threads.
+	 * With PTHREADPOOL_FLAG_DEDICATED_WORKERS, 0: all threads are worker threads, and callers only wait.
+	 */
+	size_t workers_start;
+	/**
+	 * Thread number after the last started worker thread: worker threads with numbers in the
+	 * [workers_start, started_threads_end) range are running. Equals @a threads_count after initialization, unless
+	 * the thread pool has PTHREADPOOL_FLAG_LAZY_WORKERS, and then grows as jobs need more worker threads.
+	 * Updated under @a execution_mutex.
+	 */
+	size_t started_threads_end;
+#if PTHREADPOOL_ENABLE_TRACE
+	/**
+	 * The time the thread pool was created, in nanoseconds. Timestamps in the trace are relative to this time.
+	 */
+	uint64_t trace_start_ns;
+#endif
+	/**
+	 * Thread information structures that immediately follow this structure.
+	 * The work segments of the job slots follow the thread information structures,
+	 * and the trace event ring buffers of the threads, if tracing is enabled, follow the work segments.
+	 */
+	struct thread_info threads[];
+};
+
+/*
+ * Platform layer, implemented by threadpool-pthreads.c and threadpool-minios.c.
+ */
+
+/* Returns the number of processors available to the process */
+PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors_count(void);
+
+/* Describes a logical processor available to the process */
+struct pthreadpool_processor {
+	/* Operating system number of the processor */
+	uint32_t id;
+	/* Identifier of the physical core of the processor, shared by its SMT siblings and unique across packages */
+	uint32_t core;
+	/* NUMA node of the processor */
+	uint32_t node;
+};
+
+/*
+ * Stores the descriptions of up to max_processors processors available to the process, in order of their numbers.
+ * Returns the number of descriptions stored, or 0 if the platform can't enumerate processors.
+ */
+PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors(struct pthreadpool_processor* processors, size_t max_processors);
+/* Returns the thread pool which the calling thread processes jobs of, or NULL if it processes no jobs */
+PTHREADPOOL_INTERNAL struct pthreadpool* pthreadpool_get_current_threadpool(void);
+/* Sets the thread pool which the calling thread processes jobs of, or NULL when it stops processing jobs */
+PTHREADPOOL_INTERNAL void pthreadpool_set_current_threadpool(struct pthreadpool* threadpool);
+
+/* Binds the calling thread to the processor. Failure to bind is ignored. */
+PTHREADPOOL_INTERNAL void pthreadpool_bind_current_thread(uint32_t processor);
+
+/* Returns the time from an arbitrary fixed point in the past, in nanoseconds */
+PTHREADPOOL_INTERNAL uint64_t pthreadpool_get_time_ns(void);
+
+/* Allocates memory aligned on the cache line boundary, or returns NULL on failure */
+PTHREADPOOL_INTERNAL void* pthreadpool_allocate(size_t size);
+/* Releases memory allocated with pthreadpool_allocate. NULL pointer is ignored. */
+PTHREADPOOL_INTERNAL void pthreadpool_deallocate(void* pointer);
+
+/* Starts a worker thread which runs pthreadpool_thread_main(thread). Returns false on failure. */
+PTHREADPOOL_INTERNAL bool pthreadpool_start_thread(struct thread_info* thread);
+/* Waits until a worker thread returns from pthreadpool_thread_main and releases its resources */
+PTHREADPOOL_INTERNAL void pthreadpool_join_thread(struct thread_info* thread);
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_init(pthreadpool_mutex_t* mutex);
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_lock(pthreadpool_mutex_t* mutex);
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_unlock(pthreadpool_mutex_t* mutex);
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_destroy(pthreadpool_mutex_t* mutex);
+
+/*
+ * Blocks the calling thread while *address == value. May return spuriously.
+ * The check of *address and going to sleep are atomic with respect to pthreadpool_futex_wake_all.
+ */
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wait(uint32_t* address, uint32_t value);
+/*
+ * Version of pthreadpool_futex_wait which also returns after timeout_ns nanoseconds.
+ * Returns before the timeout only if woken up, or spuriously.
+ */
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wait_timeout(uint32_t* address, uint32_t value, uint64_t timeout_ns);
+/* Wakes up all threads blocked in pthreadpool_futex_wait on the address. Never dereferences the address. */
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wake_all(uint32_t* address);
+/*
+ * Wakes up at least the specified number of threads blocked in pthreadpool_futex_wait on the address,
+ * or all of them if there are fewer. May wake up more threads. Never dereferences the address.
+ */
+PTHREADPOOL_INTERNAL void pthreadpool_futex_wake(uint32_t* address, uint32_t count);
+
+/*
+ * Portable engine, implemented by portable-api.c.
+ */
+
+/* Worker thread main loop */
+PTHREADPOOL_INTERNAL void pthreadpool_thread_main(struct thread_info* thread);
@@ -1,18 +1,30 @@
+/* CPU affinity functions are GNU extensions */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+	#define _GNU_SOURCE 1
+#endif
+
 /* Standard C headers */
-#include <stdint.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
+#include <time.h>
 
 /* POSIX headers */
 #include <pthread.h>
 #include <unistd.h>
 
 /* Platform-specific headers */
+#if defined(__ANDROID__)
+	#include <malloc.h>
+#endif
 #if defined(__linux__)
 	#define PTHREADPOOL_USE_FUTEX 1
 	#include <sys/syscall.h>
 	#include <linux/futex.h>
+	#include <dirent.h>
+	#include <sched.h>
 
 	/* Old Android NDKs do not define SYS_futex and FUTEX_PRIVATE_FLAG */
 	#ifndef SYS_futex
@@ -28,60 +40,54 @@
 	#define PTHREADPOOL_USE_FUTEX 0
 #endif
 
-/* Dependencies */
-#include <fxdiv.h>
-
-/* Library header */
-#include <pthreadpool.h>
+/* Internal headers */
+#include "threadpool-object.h"
+#include "threadpool-utils.h"
 
-#define PTHREADPOOL_CACHELINE_SIZE 64
-#define PTHREADPOOL_CACHELINE_ALIGNED __attribute__((__aligned__(PTHREADPOOL_CACHELINE_SIZE)))
 
-#if defined(__clang__)
-	#if __has_extension(c_static_assert) || __has_feature(c_static_assert)
-		#define PTHREADPOOL_STATIC_ASSERT(predicate, message) _Static_assert((predicate), message)
-	#else
-		#define PTHREADPOOL_STATIC_ASSERT(predicate, message)
-	#endif
-#elif defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4) && (__GNUC_MINOR__ >= 6))
-	/* Static assert is supported by gcc >= 4.6 */
-	#define PTHREADPOOL_STATIC_ASSERT(predicate, message) _Static_assert((predicate), message)
-#else
-	#define PTHREADPOOL_STATIC_ASSERT(predicate, message)
-#endif
-
-static inline size_t multiply_divide(size_t a, size_t b, size_t d) {
-	#if defined(__SIZEOF_SIZE_T__) && (__SIZEOF_SIZE_T__ == 4)
-		return (size_t) (((uint64_t) a) * ((uint64_t) b)) / ((uint64_t) d);
-	#elif defined(__SIZEOF_SIZE_T__) && (__SIZEOF_SIZE_T__ == 8)
-		return (size_t) (((__uint128_t) a) * ((__uint128_t) b)) / ((__uint128_t) d);
-	#else
-		#error "Unsupported platform"
-	#endif
+/* Converts a duration in nanoseconds to a timespec, saturating the seconds if they do not fit */
+static struct timespec get_timespec(uint64_t duration_ns) {
+	const uint64_t seconds = duration_ns / UINT64_C(1000000000);
+	return (struct timespec) {
+		.tv_sec = (time_t) min(seconds, INT32_MAX),
+		.tv_nsec = (long) (duration_ns % UINT64_C(1000000000)),
+	};
 }
 
-static inline size_t divide_round_up(size_t dividend, size_t divisor) {
-	if (dividend % divisor == 0) {
-		return dividend / divisor;
-	} else {
-		return dividend / divisor + 1;
+#if !PTHREADPOOL_USE_FUTEX || defined(__native_client__)
+	/* Returns the CLOCK_REALTIME time after the specified timeout, for functions which take absolute deadlines */
+	static struct timespec get_realtime_deadline(uint64_t timeout_ns) {
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		const struct timespec timeout = get_timespec(timeout_ns);
+		deadline.tv_sec += timeout.tv_sec;
+		deadline.tv_nsec += timeout.tv_nsec;
+		if (deadline.tv_nsec >= 1000000000) {
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000;
+		}
+		return deadline;
 	}
-}
-
-static inline size_t min(size_t a, size_t b) {
-	return a < b ? a : b;
-}
+#endif
 
 #if PTHREADPOOL_USE_FUTEX
 	#if defined(__linux__)
-		static int futex_wait(volatile uint32_t* address, uint32_t value) {
-			return syscall(SYS_futex, address, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, value,
-				NULL, NULL, 0);
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wait(uint32_t* address, uint32_t value) {
+			syscall(SYS_futex, address, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, value, NULL, NULL, 0);
+		}
+
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wait_timeout(uint32_t* address, uint32_t value, uint64_t timeout_ns) {
+			/* FUTEX_WAIT takes a relative timeout */
+			const struct timespec timeout = get_timespec(timeout_ns);
+			syscall(SYS_futex, address, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, value, &timeout, NULL, 0);
 		}
 
-		static int futex_wake_all(volatile uint32_t* address) {
-			return syscall(SYS_futex, address, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX,
-				NULL, NULL, 0);
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wake_all(uint32_t* address) {
+			syscall(SYS_futex, address, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX, NULL, NULL, 0);
+		}
+
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wake(uint32_t* address, uint32_t count) {
+			syscall(SYS_futex, address, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, (int) min(count, INT_MAX), NULL, NULL, 0);
 		}
 	#elif defined(__native_client__)
 		static struct nacl_irt_futex nacl_irt_futex = { 0 };
@@ -90,237 +96,237 @@ static inline size_t min(size_t a, size_t b) {
 			nacl_interface_query(NACL_IRT_FUTEX_v0_1, &nacl_irt_futex, sizeof(nacl_irt_futex));
 		}
 
-		static int futex_wait(volatile uint32_t* address, uint32_t value) {
-			return nacl_irt_futex.futex_wait_abs((volatile int*) address, (int) value, NULL);
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wait(uint32_t* address, uint32_t value) {
+			pthread_once(&nacl_init_guard, nacl_init);
+			nacl_irt_futex.futex_wait_abs((volatile int*) address, (int) value, NULL);
+		}
+
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wait_timeout(uint32_t* address, uint32_t value, uint64_t timeout_ns) {
+			const struct timespec deadline = get_realtime_deadline(timeout_ns);
+			pthread_once(&nacl_init_guard, nacl_init);
+			nacl_irt_futex.futex_wait_abs((volatile int*) address, (int) value, &deadline);
 		}
 
-		static int futex_wake_all(volatile uint32_t* address) {
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wake_all(uint32_t* address) {
 			int count;
-			return nacl_irt_futex.futex_wake((volatile int*) address, INT_MAX, &count);
+			pthread_once(&nacl_init_guard, nacl_init);
+			nacl_irt_futex.futex_wake((volatile int*) address, INT_MAX, &count);
+		}
+
+		PTHREADPOOL_INTERNAL void pthreadpool_futex_wake(uint32_t* address, uint32_t count) {
+			int woken_count;
+			pthread_once(&nacl_init_guard, nacl_init);
+			nacl_irt_futex.futex_wake((volatile int*) address, (int) min(count, INT_MAX), &woken_count);
 		}
 	#else
 		#error "Platform-specific implementation of futex_wait and futex_wake_all required"
 	#endif
-#endif
-
-#define THREADPOOL_COMMAND_MASK UINT32_C(0x7FFFFFFF)
+#else
+	/*
+	 * Without a native futex, emulate it with condition variables.
+	 * Addresses are hashed into a small set of buckets; threads waiting on different addresses
+	 * in the same bucket are woken up spuriously and go back to sleep after re-checking the value.
+	 */
+	#define PTHREADPOOL_FUTEX_BUCKETS 16
 
-enum threadpool_command {
-	threadpool_command_init,
-	threadpool_command_compute_1d,
-	threadpool_command_shutdown,
-};
+	static struct PTHREADPOOL_CACHELINE_ALIGNED futex_bucket {
+		pthread_mutex_t mutex;
+		pthread_cond_t condvar;
+	} futex_buckets[PTHREADPOOL_FUTEX_BUCKETS];
+	static pthread_once_t futex_init_guard = PTHREAD_ONCE_INIT;
 
-struct PTHREADPOOL_CACHELINE_ALIGNED thread_info {
-	/**
-	 * Index of the first element in the work range.
-	 * Before processing a new element the owning worker thread increments this value.
-	 */
-	volatile size_t range_start;
-	/**
-	 * Index of the element after the last element of the work range.
-	 * Before processing a new element the stealing worker thread decrements this value.
-	 */
-	volatile size_t range_end;
-	/**
-	 * The number of elements in the work range.
-	 * Due to race conditions range_length <= range_end - range_start.
-	 * The owning worker thread must decrement this value before incrementing @a range_start.
-	 * The stealing worker thread must decrement this value before decrementing @a range_end.
-	 */
-	volatile size_t range_length;
-	/**
-	 * Thread number in the 0..threads_count-1 range.
-	 */
-	size_t thread_number;
-	/**
-	 * The pthread object corresponding to the thread.
-	 */
-	// pthread_t thread_object;
-	/**
-	 * Condition variable used to wake up the thread.
-	 * When the thread is idle, it waits on this condition variable.
-	 */
-	// pthread_cond_t wakeup_condvar;
-};
+	static void futex_init(void) {
+		for (size_t i = 0; i < PTHREADPOOL_FUTEX_BUCKETS; i++) {
+			pthread_mutex_init(&futex_buckets[i].mutex, NULL);
+			pthread_cond_init(&futex_buckets[i].condvar, NULL);
+		}
+	}
 
-PTHREADPOOL_STATIC_ASSERT(sizeof(struct thread_info) % PTHREADPOOL_CACHELINE_SIZE == 0, "thread_info structure must occupy an integer number of cache lines (64 bytes)");
+	static struct futex_bucket* futex_get_bucket(uint32_t* address) {
+		pthread_once(&futex_init_guard, futex_init);
+		return &futex_buckets[((uintptr_t) address / sizeof(uint32_t)) % PTHREADPOOL_FUTEX_BUCKETS];
+	}
 
-struct PTHREADPOOL_CACHELINE_ALIGNED pthreadpool {
-	/**
-	 * The number of threads that are processing an operation.
-	 */
-	volatile size_t active_threads;
-#if PTHREADPOOL_USE_FUTEX
-	/**
-	 * Indicates if there are active threads.
-	 * Only two values are possible:
-	 * - has_active_threads == 0 if active_threads == 0
-	 * - has_active_threads == 1 if active_threads != 0
-	 */
-	volatile uint32_t has_active_threads;
-#endif
-	/**
-	 * The last command submitted to the thread pool.
-	 */
-	volatile uint32_t command;
-	/**
-	 * The function to call for each item.
-	 */
-	volatile void* function;
-	/**
-	 * The first argument to the item processing function.
-	 */
-	void *volatile argument;
-	/**
-	 * Serializes concurrent calls to @a pthreadpool_compute_* from different threads.
-	 */
-	pthread_mutex_t execution_mutex;
-#if !PTHREADPOOL_USE_FUTEX
-	/**
-	 * Guards access to the @a active_threads variable.
-	 */
-	pthread_mutex_t completion_mutex;
-	/**
-	 * Condition variable to wait until all threads complete an operation (until @a active_threads is zero).
-	 */
-	// pthread_cond_t completion_condvar;
-	/**
-	 * Guards access to the @a command variable.
-	 */
-	pthread_mutex_t command_mutex;
-	/**
-	 * Condition variable to wait for change of the @a command variable.
-	 */
-	// pthread_cond_t command_condvar;
-#endif
-	/**
-	 * The number of threads in the thread pool. Never changes after initialization.
-	 */
-	size_t threads_count;
-	/**
-	 * Thread information structures that immediately follow this structure.
-	 */
-	struct thread_info threads[];
-};
-
-size_t pthreadpool_get_threads_count(struct pthreadpool* threadpool) {
-	if (threadpool == NULL) {
-		return 1;
-	} else {
-		return threadpool->threads_count;
+	PTHREADPOOL_INTERNAL void pthreadpool_futex_wait(uint32_t* address, uint32_t value) {
+		struct futex_bucket* bucket = futex_get_bucket(address);
+		pthread_mutex_lock(&bucket->mutex);
+		if (__atomic_load_n(address, __ATOMIC_ACQUIRE) == value) {
+			pthread_cond_wait(&bucket->condvar, &bucket->mutex);
+		}
+		pthread_mutex_unlock(&bucket->mutex);
 	}
-}
 
-void pthreadpool_compute_1d(
-	struct pthreadpool* threadpool,
-	pthreadpool_function_1d_t function,
-	void* argument,
-	size_t range)
-{
-	if (threadpool == NULL) {
-		/* No thread pool provided: execute function sequentially on the calling thread */
-		for (size_t i = 0; i < range; i++) {
-			function(argument, i);
+	PTHREADPOOL_INTERNAL void pthreadpool_futex_wait_timeout(uint32_t* address, uint32_t value, uint64_t timeout_ns) {
+		const struct timespec deadline = get_realtime_deadline(timeout_ns);
+		struct futex_bucket* bucket = futex_get_bucket(address);
+		pthread_mutex_lock(&bucket->mutex);
+		if (__atomic_load_n(address, __ATOMIC_ACQUIRE) == value) {
+			pthread_cond_timedwait(&bucket->condvar, &bucket->mutex, &deadline);
 		}
+		pthread_mutex_unlock(&bucket->mutex);
+	}
+
+	PTHREADPOOL_INTERNAL void pthreadpool_futex_wake_all(uint32_t* address) {
+		struct futex_bucket* bucket = futex_get_bucket(address);
+		/* Taking the lock orders the wake-up after any waiter which has checked the old value */
+		pthread_mutex_lock(&bucket->mutex);
+		pthread_cond_broadcast(&bucket->condvar);
+		pthread_mutex_unlock(&bucket->mutex);
 	}
-}
 
-struct compute_1d_tiled_context {
-	pthreadpool_function_1d_tiled_t function;
-	void* argument;
-	size_t range;
-	size_t tile;
-};
-
-static void compute_1d_tiled(const struct compute_1d_tiled_context* context, size_t linear_index) {
-	const size_t tile_index = linear_index;
-	const size_t index = tile_index * context->tile;
-	const size_t tile = min(context->tile, context->range - index);
-	context->function(context->argument, index, tile);
+	PTHREADPOOL_INTERNAL void pthreadpool_futex_wake(uint32_t* address, uint32_t count) {
+		/* Signalling a few waiters could wake up waiters on other addresses in the bucket instead */
+		pthreadpool_futex_wake_all(address);
+	}
+#endif
+
+PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors_count(void) {
+	return (size_t) sysconf(_SC_NPROCESSORS_ONLN);
 }
 
-void pthreadpool_compute_1d_tiled(
-	pthreadpool_t threadpool,
-	pthreadpool_function_1d_tiled_t function,
-	void* argument,
-	size_t range,
-	size_t tile)
-{
-	if (threadpool == NULL) {
-		/* No thread pool provided: execute function sequentially on the calling thread */
-		for (size_t i = 0; i < range; i += tile) {
-			function(argument, i, min(range - i, tile));
+#if defined(__linux__)
+	/* Reads the first number in a sysfs file, such as "4" in a "4,68" or "4-5" list */
+	static uint32_t read_sysfs_number(const char* path, uint32_t default_value) {
+		uint32_t value = default_value;
+		FILE* file = fopen(path, "r");
+		if (file != NULL) {
+			unsigned int number;
+			if (fscanf(file, "%u", &number) == 1) {
+				value = (uint32_t) number;
+			}
+			fclose(file);
 		}
+		return value;
 	}
-}
 
-struct compute_2d_context {
-	pthreadpool_function_2d_t function;
-	void* argument;
-	struct fxdiv_divisor_size_t range_j;
-};
+	/* The NUMA node of a processor is indicated by a nodeN link in the processor's sysfs directory */
+	static uint32_t read_sysfs_processor_node(uint32_t processor) {
+		uint32_t node = 0;
+		char path[64];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", (unsigned int) processor);
+		DIR* directory = opendir(path);
+		if (directory != NULL) {
+			const struct dirent* entry;
+			while ((entry = readdir(directory)) != NULL) {
+				unsigned int number;
+				if (sscanf(entry->d_name, "node%u", &number) == 1) {
+					node = (uint32_t) number;
+					break;
+				}
+			}
+			closedir(directory);
+		}
+		return node;
+	}
 
-static void compute_2d(const struct compute_2d_context* context, size_t linear_index) {
-	const struct fxdiv_divisor_size_t range_j = context->range_j;
-	const struct fxdiv_result_size_t index = fxdiv_divide_size_t(linear_index, range_j);
-	context->function(context->argument, index.quotient, index.remainder);
-}
+	PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors(struct pthreadpool_processor* processors, size_t max_processors) {
+		cpu_set_t allowed_processors;
+		if (sched_getaffinity(0, sizeof(allowed_processors), &allowed_processors) != 0) {
+			return 0;
+		}
 
-void pthreadpool_compute_2d(
-	struct pthreadpool* threadpool,
-	pthreadpool_function_2d_t function,
-	void* argument,
-	size_t range_i,
-	size_t range_j)
-{
-	if (threadpool == NULL) {
-		/* No thread pool provided: execute function sequentially on the calling thread */
-		for (size_t i = 0; i < range_i; i++) {
-			for (size_t j = 0; j < range_j; j++) {
-				function(argument, i, j);
+		size_t processors_count = 0;
+		for (uint32_t processor = 0; processor < CPU_SETSIZE && processors_count < max_processors; processor++) {
+			if (CPU_ISSET(processor, &allowed_processors)) {
+				/* SMT siblings share the thread_siblings_list, so its first processor identifies the physical core */
+				char path[96];
+				snprintf(path, sizeof(path),
+					"/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", (unsigned int) processor);
+				processors[processors_count++] = (struct pthreadpool_processor) {
+					.id = processor,
+					.core = read_sysfs_number(path, processor),
+					.node = read_sysfs_processor_node(processor),
+				};
 			}
 		}
+		return processors_count;
 	}
+
+	PTHREADPOOL_INTERNAL void pthreadpool_bind_current_thread(uint32_t processor) {
+		if (processor < CPU_SETSIZE) {
+			cpu_set_t processors;
+			CPU_ZERO(&processors);
+			CPU_SET(processor, &processors);
+			#if defined(__ANDROID__)
+				/* Bionic lacks pthread_setaffinity_np, but on Linux sched_setaffinity(0, ...) binds only the calling thread */
+				sched_setaffinity(0, sizeof(processors), &processors);
+			#else
+				pthread_setaffinity_np(pthread_self(), sizeof(processors), &processors);
+			#endif
+		}
+	}
+#else
+	/* Processor topology and thread binding are not supported: leave the threads unbound */
+	PTHREADPOOL_INTERNAL size_t pthreadpool_get_processors(struct pthreadpool_processor* processors, size_t max_processors) {
+		return 0;
+	}
+
+	PTHREADPOOL_INTERNAL void pthreadpool_bind_current_thread(uint32_t processor) {
+	}
+#endif
+
+PTHREADPOOL_INTERNAL void* pthreadpool_allocate(size_t size) {
+	void* pointer = NULL;
+	#if defined(__ANDROID__)
+		/*
+		 * Android didn't get posix_memalign until API level 17 (Android 4.2).
+		 * Use (otherwise obsolete) memalign function on Android platform.
+		 */
+		pointer = memalign(PTHREADPOOL_CACHELINE_SIZE, size);
+	#else
+		if (posix_memalign(&pointer, PTHREADPOOL_CACHELINE_SIZE, size) != 0) {
+			return NULL;
+		}
+	#endif
+	return pointer;
 }
 
-struct compute_2d_tiled_context {
-	pthreadpool_function_2d_tiled_t function;
-	void* argument;
-	struct fxdiv_divisor_size_t tile_range_j;
-	size_t range_i;
-	size_t range_j;
-	size_t tile_i;
-	size_t tile_j;
-};
-
-static void compute_2d_tiled(const struct compute_2d_tiled_context* context, size_t linear_index) {
-	const struct fxdiv_divisor_size_t tile_range_j = context->tile_range_j;
-	const struct fxdiv_result_size_t tile_index = fxdiv_divide_size_t(linear_index, tile_range_j);
-	const size_t max_tile_i = context->tile_i;
-	const size_t max_tile_j = context->tile_j;
-	const size_t index_i = tile_index.quotient * max_tile_i;
-	const size_t index_j = tile_index.remainder * max_tile_j;
-	const size_t tile_i = min(max_tile_i, context->range_i - index_i);
-	const size_t tile_j = min(max_tile_j, context->range_j - index_j);
-	context->function(context->argument, index_i, index_j, tile_i, tile_j);
+PTHREADPOOL_INTERNAL void pthreadpool_deallocate(void* pointer) {
+	free(pointer);
 }
 
-void pthreadpool_compute_2d_tiled(
-	pthreadpool_t threadpool,
-	pthreadpool_function_2d_tiled_t function,
-	void* argument,
-	size_t range_i,
-	size_t range_j,
-	size_t tile_i,
-	size_t tile_j)
-{
-	if (threadpool == NULL) {
-		/* No thread pool provided: execute function sequentially on the calling thread */
-		for (size_t i = 0; i < range_i; i += tile_i) {
-			for (size_t j = 0; j < range_j; j += tile_j) {
-				function(argument, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
-			}
-		}
-	}
+PTHREADPOOL_INTERNAL uint64_t pthreadpool_get_time_ns(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64_t) time.tv_sec * UINT64_C(1000000000) + (uint64_t) time.tv_nsec;
+}
+
+/* The thread pool which the thread processes jobs of */
+static __thread struct pthreadpool* current_threadpool = NULL;
+
+PTHREADPOOL_INTERNAL struct pthreadpool* pthreadpool_get_current_threadpool(void) {
+	return current_threadpool;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_set_current_threadpool(struct pthreadpool* threadpool) {
+	current_threadpool = threadpool;
+}
+
+static void* thread_main(void* arg) {
+	pthreadpool_thread_main((struct thread_info*) arg);
+	return NULL;
+}
+
+PTHREADPOOL_INTERNAL bool pthreadpool_start_thread(struct thread_info* thread) {
+	return pthread_create(&thread->thread_object, NULL, &thread_main, thread) == 0;
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_join_thread(struct thread_info* thread) {
+	pthread_join(thread->thread_object, NULL);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_init(pthreadpool_mutex_t* mutex) {
+	pthread_mutex_init(mutex, NULL);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_lock(pthreadpool_mutex_t* mutex) {
+	pthread_mutex_lock(mutex);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_unlock(pthreadpool_mutex_t* mutex) {
+	pthread_mutex_unlock(mutex);
+}
+
+PTHREADPOOL_INTERNAL void pthreadpool_mutex_destroy(pthreadpool_mutex_t* mutex) {
+	pthread_mutex_destroy(mutex);
 }
@@ -1,21 +1,66 @@
+/* posix_memalign is a POSIX extension hidden in strict C99 mode */
+#ifndef _POSIX_C_SOURCE
+	#define _POSIX_C_SOURCE 200112L
+#endif
+
 /* Standard C headers */
+#include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 /* Library header */
 #include <pthreadpool.h>
 
-static inline size_t min(size_t a, size_t b) {
-	return a < b ? a : b;
-}
+/* Internal headers */
+#include "threadpool-utils.h"
 
 struct pthreadpool* pthreadpool_create(size_t threads_count) {
 	return NULL;
 }
 
+struct pthreadpool* pthreadpool_create_with_attributes(const struct pthreadpool_attributes* attributes) {
+	return NULL;
+}
+
+struct pthreadpool* pthreadpool_get_default(void) {
+	return NULL;
+}
+
 size_t pthreadpool_get_threads_count(struct pthreadpool* threadpool) {
 	return 1;
 }
 
+int pthreadpool_set_threads_count(struct pthreadpool* threadpool, size_t threads_count) {
+	return threads_count == 1 ? 0 : EINVAL;
+}
+
+void pthreadpool_set_spin_wait_iterations(struct pthreadpool* threadpool, uint32_t iterations) {
+}
+
+void pthreadpool_set_idle_policy(
+	struct pthreadpool* threadpool,
+	size_t warm_threads_count,
+	uint64_t hibernation_delay_ns)
+{
+}
+
+int pthreadpool_get_stats(
+	struct pthreadpool* threadpool,
+	struct pthreadpool_thread_stats* stats,
+	size_t stats_count)
+{
+	return ENOTSUP;
+}
+
+int pthreadpool_get_trace(
+	struct pthreadpool* threadpool,
+	char* buffer,
+	size_t* size)
+{
+	return ENOTSUP;
+}
+
 void pthreadpool_compute_1d(
 	struct pthreadpool* threadpool,
 	pthreadpool_function_1d_t function,
@@ -27,6 +72,36 @@ void pthreadpool_compute_1d(
 	}
 }
 
+void pthreadpool_compute_1d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d(threadpool, function, argument, range);
+}
+
+void pthreadpool_compute_1d_with_max_threads(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t max_threads)
+{
+	pthreadpool_compute_1d(threadpool, function, argument, range);
+}
+
+void pthreadpool_compute_1d_with_grain(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t grain)
+{
+	pthreadpool_compute_1d(threadpool, function, argument, range);
+}
+
 void pthreadpool_compute_1d_tiled(
 	pthreadpool_t threadpool,
 	pthreadpool_function_1d_tiled_t function,
@@ -39,6 +114,49 @@ void pthreadpool_compute_1d_tiled(
 	}
 }
 
+void pthreadpool_compute_1d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled(threadpool, function, argument, range, tile);
+}
+
+void pthreadpool_compute_1d_tiled_aligned(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width)
+{
+	const size_t head = get_aligned_head(range, offset, vector_width);
+	if (head != 0) {
+		function(argument, 0, head);
+	}
+	tile = get_aligned_tile(tile, vector_width);
+	for (size_t i = head; i < range; i += tile) {
+		function(argument, i, min(range - i, tile));
+	}
+}
+
+void pthreadpool_compute_1d_tiled_aligned_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t offset,
+	size_t vector_width,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled_aligned(threadpool, function, argument, range, tile, offset, vector_width);
+}
+
 void pthreadpool_compute_2d(
 	struct pthreadpool* threadpool,
 	pthreadpool_function_2d_t function,
@@ -53,6 +171,28 @@ void pthreadpool_compute_2d(
 	}
 }
 
+void pthreadpool_compute_2d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	uint32_t flags)
+{
+	pthreadpool_compute_2d(threadpool, function, argument, range_i, range_j);
+}
+
+void pthreadpool_compute_2d_with_grain(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t grain)
+{
+	pthreadpool_compute_2d(threadpool, function, argument, range_i, range_j);
+}
+
 void pthreadpool_compute_2d_tiled(
 	pthreadpool_t threadpool,
 	pthreadpool_function_2d_tiled_t function,
@@ -69,5 +209,732 @@ void pthreadpool_compute_2d_tiled(
 	}
 }
 
+void pthreadpool_compute_2d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags)
+{
+	const uint32_t traversal = flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		pthreadpool_compute_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j);
+		return;
+	}
+	const size_t tile_ranges[2] = { divide_round_up(range_i, tile_i), divide_round_up(range_j, tile_j) };
+	const struct tile_curve curve = make_tile_curve(2, tile_ranges, traversal == PTHREADPOOL_FLAG_TRAVERSAL_HILBERT);
+	for (size_t linear_index = 0; linear_index < tile_ranges[0] * tile_ranges[1]; linear_index++) {
+		size_t tile_index[2];
+		if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR) {
+			tile_index[0] = linear_index % tile_ranges[0];
+			tile_index[1] = linear_index / tile_ranges[0];
+		} else {
+			locate_curve_tile(&curve, linear_index, tile_index);
+		}
+		const size_t i = tile_index[0] * tile_i;
+		const size_t j = tile_index[1] * tile_j;
+		function(argument, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
+	}
+}
+
+int pthreadpool_compute_2d_tiled_with_scratch(
+	pthreadpool_t threadpool,
+	pthreadpool_function_2d_tiled_with_scratch_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t scratch_size)
+{
+	void* scratch = NULL;
+	if (scratch_size != 0) {
+		/* Match the cache line alignment guaranteed by the thread pool implementation */
+		if (posix_memalign(&scratch, 64, scratch_size) != 0) {
+			return ENOMEM;
+		}
+	}
+	for (size_t i = 0; i < range_i; i += tile_i) {
+		for (size_t j = 0; j < range_j; j += tile_j) {
+			function(argument, 0, scratch, i, j, min(range_i - i, tile_i), min(range_j - j, tile_j));
+		}
+	}
+	free(scratch);
+	return 0;
+}
+
+void pthreadpool_compute_3d(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k)
+{
+	for (size_t i = 0; i < range_i; i++) {
+		for (size_t j = 0; j < range_j; j++) {
+			for (size_t k = 0; k < range_k; k++) {
+				function(argument, i, j, k);
+			}
+		}
+	}
+}
+
+void pthreadpool_compute_3d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k)
+{
+	for (size_t i = 0; i < range_i; i += tile_i) {
+		for (size_t j = 0; j < range_j; j += tile_j) {
+			for (size_t k = 0; k < range_k; k += tile_k) {
+				function(argument, i, j, k,
+					min(range_i - i, tile_i), min(range_j - j, tile_j), min(range_k - k, tile_k));
+			}
+		}
+	}
+}
+
+void pthreadpool_compute_3d_tiled_with_flags(
+	pthreadpool_t threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k,
+	uint32_t flags)
+{
+	const uint32_t traversal = flags & PTHREADPOOL_FLAG_TRAVERSAL_MASK;
+	if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR) {
+		pthreadpool_compute_3d_tiled(threadpool, function, argument, range_i, range_j, range_k, tile_i, tile_j, tile_k);
+		return;
+	}
+	const size_t tile_ranges[3] = {
+		divide_round_up(range_i, tile_i),
+		divide_round_up(range_j, tile_j),
+		divide_round_up(range_k, tile_k),
+	};
+	const struct tile_curve curve = make_tile_curve(3, tile_ranges, traversal == PTHREADPOOL_FLAG_TRAVERSAL_HILBERT);
+	for (size_t linear_index = 0; linear_index < tile_ranges[0] * tile_ranges[1] * tile_ranges[2]; linear_index++) {
+		size_t tile_index[3];
+		if (traversal == PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR) {
+			tile_index[0] = linear_index % tile_ranges[0];
+			tile_index[1] = linear_index / tile_ranges[0] % tile_ranges[1];
+			tile_index[2] = linear_index / tile_ranges[0] / tile_ranges[1];
+		} else {
+			locate_curve_tile(&curve, linear_index, tile_index);
+		}
+		const size_t i = tile_index[0] * tile_i;
+		const size_t j = tile_index[1] * tile_j;
+		const size_t k = tile_index[2] * tile_k;
+		function(argument, i, j, k, min(range_i - i, tile_i), min(range_j - j, tile_j), min(range_k - k, tile_k));
+	}
+}
+
+void pthreadpool_compute_4d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l)
+{
+	for (size_t i = 0; i < range_i; i++) {
+		for (size_t j = 0; j < range_j; j++) {
+			for (size_t k = 0; k < range_k; k += tile_k) {
+				for (size_t l = 0; l < range_l; l += tile_l) {
+					function(argument, i, j, k, l, min(range_k - k, tile_k), min(range_l - l, tile_l));
+				}
+			}
+		}
+	}
+}
+
+void pthreadpool_compute_5d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m)
+{
+	for (size_t i = 0; i < range_i; i++) {
+		for (size_t j = 0; j < range_j; j++) {
+			for (size_t k = 0; k < range_k; k++) {
+				for (size_t l = 0; l < range_l; l += tile_l) {
+					for (size_t m = 0; m < range_m; m += tile_m) {
+						function(argument, i, j, k, l, m, min(range_l - l, tile_l), min(range_m - m, tile_m));
+					}
+				}
+			}
+		}
+	}
+}
+
+void pthreadpool_compute_6d_tiled(
+	pthreadpool_t threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n)
+{
+	for (size_t i = 0; i < range_i; i++) {
+		for (size_t j = 0; j < range_j; j++) {
+			for (size_t k = 0; k < range_k; k++) {
+				for (size_t l = 0; l < range_l; l++) {
+					for (size_t m = 0; m < range_m; m += tile_m) {
+						for (size_t n = 0; n < range_n; n += tile_n) {
+							function(argument, i, j, k, l, m, n, min(range_m - m, tile_m), min(range_n - n, tile_n));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range)
+{
+	pthreadpool_compute_1d(threadpool, function, argument, range);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d(threadpool, function, argument, range);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	pthreadpool_compute_1d_tiled(threadpool, function, argument, range, tile);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_1d_tiled_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	uint32_t flags)
+{
+	pthreadpool_compute_1d_tiled(threadpool, function, argument, range, tile);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j)
+{
+	pthreadpool_compute_2d(threadpool, function, argument, range_i, range_j);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	pthreadpool_compute_2d_tiled(threadpool, function, argument, range_i, range_j, tile_i, tile_j);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_2d_tiled_with_flags(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	uint32_t flags)
+{
+	pthreadpool_compute_2d_tiled_with_flags(threadpool, function, argument, range_i, range_j, tile_i, tile_j, flags);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_3d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_3d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k)
+{
+	pthreadpool_compute_3d(threadpool, function, argument, range_i, range_j, range_k);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_3d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_3d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t tile_i,
+	size_t tile_j,
+	size_t tile_k)
+{
+	pthreadpool_compute_3d_tiled(threadpool, function, argument, range_i, range_j, range_k, tile_i, tile_j, tile_k);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_4d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_4d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t tile_k,
+	size_t tile_l)
+{
+	pthreadpool_compute_4d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, tile_k, tile_l);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_5d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_5d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t tile_l,
+	size_t tile_m)
+{
+	pthreadpool_compute_5d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, tile_l, tile_m);
+	return 0;
+}
+
+pthreadpool_completion_t pthreadpool_submit_6d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_6d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t range_k,
+	size_t range_l,
+	size_t range_m,
+	size_t range_n,
+	size_t tile_m,
+	size_t tile_n)
+{
+	pthreadpool_compute_6d_tiled(threadpool, function, argument, range_i, range_j, range_k, range_l, range_m, range_n, tile_m, tile_n);
+	return 0;
+}
+
+int pthreadpool_reduce_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_reduce_1d_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range)
+{
+	for (size_t i = 0; i < range; i++) {
+		function(argument, accumulator, i);
+	}
+	return 0;
+}
+
+int pthreadpool_reduce_1d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_reduce_1d_tiled_t function,
+	pthreadpool_function_combine_t combine,
+	void* argument,
+	void* accumulator,
+	size_t accumulator_size,
+	size_t range,
+	size_t tile)
+{
+	for (size_t i = 0; i < range; i += tile) {
+		function(argument, accumulator, i, min(range - i, tile));
+	}
+	return 0;
+}
+
+void pthreadpool_wait(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+}
+
+int pthreadpool_test(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+	return 1;
+}
+
+void pthreadpool_cancel(struct pthreadpool* threadpool, pthreadpool_completion_t completion) {
+}
+
+int pthreadpool_compute_1d_cancellable(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_cancellable_t function,
+	void* argument,
+	size_t range)
+{
+	for (size_t i = 0; i < range; i++) {
+		if (function(argument, i) != 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int pthreadpool_compute_1d_tiled_cancellable(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_tiled_cancellable_t function,
+	void* argument,
+	size_t range,
+	size_t tile)
+{
+	for (size_t i = 0; i < range; i += tile) {
+		if (function(argument, i, min(range - i, tile)) != 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void pthreadpool_compute_batch(
+	struct pthreadpool* threadpool,
+	const struct pthreadpool_loop* loops,
+	size_t loops_count)
+{
+	for (size_t i = 0; i < loops_count; i++) {
+		const struct pthreadpool_loop* loop = &loops[i];
+		switch (loop->type) {
+			case pthreadpool_loop_1d:
+				pthreadpool_compute_1d(threadpool, loop->function.function_1d, loop->argument, loop->range_i);
+				break;
+			case pthreadpool_loop_1d_tiled:
+				pthreadpool_compute_1d_tiled(threadpool, loop->function.function_1d_tiled, loop->argument,
+					loop->range_i, loop->tile_i);
+				break;
+			case pthreadpool_loop_2d:
+				pthreadpool_compute_2d(threadpool, loop->function.function_2d, loop->argument,
+					loop->range_i, loop->range_j);
+				break;
+			case pthreadpool_loop_2d_tiled:
+				pthreadpool_compute_2d_tiled(threadpool, loop->function.function_2d_tiled, loop->argument,
+					loop->range_i, loop->range_j, loop->tile_i, loop->tile_j);
+				break;
+		}
+	}
+}
+
+enum plan_type {
+	plan_1d,
+	plan_1d_tiled,
+	plan_2d,
+	plan_2d_tiled,
+};
+
+struct pthreadpool_plan {
+	enum plan_type type;
+	void* function;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+static struct pthreadpool_plan* create_plan(struct pthreadpool_plan plan) {
+	struct pthreadpool_plan* new_plan = malloc(sizeof(struct pthreadpool_plan));
+	if (new_plan != NULL) {
+		*new_plan = plan;
+	}
+	return new_plan;
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_1d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_t function,
+	size_t range)
+{
+	const struct pthreadpool_plan plan = {
+		.type = plan_1d,
+		.function = (void*) function,
+		.range_i = range,
+	};
+	return create_plan(plan);
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_1d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_1d_tiled_t function,
+	size_t range,
+	size_t tile)
+{
+	const struct pthreadpool_plan plan = {
+		.type = plan_1d_tiled,
+		.function = (void*) function,
+		.range_i = range,
+		.tile_i = tile,
+	};
+	return create_plan(plan);
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_2d(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_t function,
+	size_t range_i,
+	size_t range_j)
+{
+	const struct pthreadpool_plan plan = {
+		.type = plan_2d,
+		.function = (void*) function,
+		.range_i = range_i,
+		.range_j = range_j,
+	};
+	return create_plan(plan);
+}
+
+struct pthreadpool_plan* pthreadpool_plan_create_2d_tiled(
+	struct pthreadpool* threadpool,
+	pthreadpool_function_2d_tiled_t function,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j)
+{
+	const struct pthreadpool_plan plan = {
+		.type = plan_2d_tiled,
+		.function = (void*) function,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+	};
+	return create_plan(plan);
+}
+
+void pthreadpool_plan_execute(struct pthreadpool_plan* plan, void* argument) {
+	switch (plan->type) {
+		case plan_1d:
+			pthreadpool_compute_1d(NULL, (pthreadpool_function_1d_t) plan->function, argument,
+				plan->range_i);
+			break;
+		case plan_1d_tiled:
+			pthreadpool_compute_1d_tiled(NULL, (pthreadpool_function_1d_tiled_t) plan->function, argument,
+				plan->range_i, plan->tile_i);
+			break;
+		case plan_2d:
+			pthreadpool_compute_2d(NULL, (pthreadpool_function_2d_t) plan->function, argument,
+				plan->range_i, plan->range_j);
+			break;
+		case plan_2d_tiled:
+			pthreadpool_compute_2d_tiled(NULL, (pthreadpool_function_2d_tiled_t) plan->function, argument,
+				plan->range_i, plan->range_j, plan->tile_i, plan->tile_j);
+			break;
+	}
+}
+
+void pthreadpool_plan_destroy(struct pthreadpool_plan* plan) {
+	free(plan);
+}
+
+enum graph_node_type {
+	graph_node_1d,
+	graph_node_1d_tiled,
+	graph_node_2d,
+	graph_node_2d_tiled,
+};
+
+struct graph_node {
+	enum graph_node_type type;
+	void* function;
+	void* argument;
+	size_t range_i;
+	size_t range_j;
+	size_t tile_i;
+	size_t tile_j;
+};
+
+/* Without threads, the nodes run in the order they were added, which satisfies the dependencies */
+struct pthreadpool_graph {
+	struct graph_node* nodes;
+	size_t nodes_count;
+	size_t nodes_capacity;
+};
+
+struct pthreadpool_graph* pthreadpool_graph_create(void) {
+	return calloc(1, sizeof(struct pthreadpool_graph));
+}
+
+static int add_graph_node(struct pthreadpool_graph* graph, struct graph_node node, size_t* node_id) {
+	if (graph->nodes_count == graph->nodes_capacity) {
+		const size_t new_capacity = graph->nodes_capacity == 0 ? 8 : graph->nodes_capacity * 2;
+		struct graph_node* new_nodes = realloc(graph->nodes, new_capacity * sizeof(struct graph_node));
+		if (new_nodes == NULL) {
+			return ENOMEM;
+		}
+		graph->nodes = new_nodes;
+		graph->nodes_capacity = new_capacity;
+	}
+	graph->nodes[graph->nodes_count] = node;
+	*node_id = graph->nodes_count++;
+	return 0;
+}
+
+int pthreadpool_graph_add_1d(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_1d_t function,
+	void* argument,
+	size_t range,
+	size_t* node)
+{
+	const struct graph_node graph_node = {
+		.type = graph_node_1d,
+		.function = (void*) function,
+		.argument = argument,
+		.range_i = range,
+	};
+	return add_graph_node(graph, graph_node, node);
+}
+
+int pthreadpool_graph_add_1d_tiled(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_1d_tiled_t function,
+	void* argument,
+	size_t range,
+	size_t tile,
+	size_t* node)
+{
+	const struct graph_node graph_node = {
+		.type = graph_node_1d_tiled,
+		.function = (void*) function,
+		.argument = argument,
+		.range_i = range,
+		.tile_i = tile,
+	};
+	return add_graph_node(graph, graph_node, node);
+}
+
+int pthreadpool_graph_add_2d(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_2d_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t* node)
+{
+	const struct graph_node graph_node = {
+		.type = graph_node_2d,
+		.function = (void*) function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+	};
+	return add_graph_node(graph, graph_node, node);
+}
+
+int pthreadpool_graph_add_2d_tiled(
+	struct pthreadpool_graph* graph,
+	pthreadpool_function_2d_tiled_t function,
+	void* argument,
+	size_t range_i,
+	size_t range_j,
+	size_t tile_i,
+	size_t tile_j,
+	size_t* node)
+{
+	const struct graph_node graph_node = {
+		.type = graph_node_2d_tiled,
+		.function = (void*) function,
+		.argument = argument,
+		.range_i = range_i,
+		.range_j = range_j,
+		.tile_i = tile_i,
+		.tile_j = tile_j,
+	};
+	return add_graph_node(graph, graph_node, node);
+}
+
+int pthreadpool_graph_add_dependency(struct pthreadpool_graph* graph, size_t node, size_t dependency) {
+	return node < graph->nodes_count && dependency < node ? 0 : EINVAL;
+}
+
+int pthreadpool_graph_run(struct pthreadpool* threadpool, struct pthreadpool_graph* graph) {
+	for (size_t i = 0; i < graph->nodes_count; i++) {
+		const struct graph_node* node = &graph->nodes[i];
+		switch (node->type) {
+			case graph_node_1d:
+				pthreadpool_compute_1d(threadpool, (pthreadpool_function_1d_t) node->function, node->argument,
+					node->range_i);
+				break;
+			case graph_node_1d_tiled:
+				pthreadpool_compute_1d_tiled(threadpool, (pthreadpool_function_1d_tiled_t) node->function, node->argument,
+					node->range_i, node->tile_i);
+				break;
+			case graph_node_2d:
+				pthreadpool_compute_2d(threadpool, (pthreadpool_function_2d_t) node->function, node->argument,
+					node->range_i, node->range_j);
+				break;
+			case graph_node_2d_tiled:
+				pthreadpool_compute_2d_tiled(threadpool, (pthreadpool_function_2d_tiled_t) node->function, node->argument,
+					node->range_i, node->range_j, node->tile_i, node->tile_j);
+				break;
+		}
+	}
+	return 0;
+}
+
+void pthreadpool_graph_destroy(struct pthreadpool_graph* graph) {
+	if (graph != NULL) {
+		free(graph->nodes);
+		free(graph);
+	}
+}
+
 void pthreadpool_destroy(struct pthreadpool* threadpool) {
 }
@@ -0,0 +1,199 @@
+#pragma once
+
+/* Standard C headers */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PTHREADPOOL_CACHELINE_SIZE 64
+#define PTHREADPOOL_CACHELINE_ALIGNED __attribute__((__aligned__(PTHREADPOOL_CACHELINE_SIZE)))
+
+/* Functions shared between the portable engine and the platform layers, but not exported from the library */
+#if defined(__ELF__) || defined(__APPLE__)
+	#define PTHREADPOOL_INTERNAL __attribute__((__visibility__("hidden")))
+#else
+	#define PTHREADPOOL_INTERNAL
+#endif
+
+#if defined(__clang__)
+	#if __has_extension(c_static_assert) || __has_feature(c_static_assert)
+		#define PTHREADPOOL_STATIC_ASSERT(predicate, message) _Static_assert((predicate), message)
+	#else
+		#define PTHREADPOOL_STATIC_ASSERT(predicate, message)
+	#endif
+#elif defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4) && (__GNUC_MINOR__ >= 6))
+	/* Static assert is supported by gcc >= 4.6 */
+	#define PTHREADPOOL_STATIC_ASSERT(predicate, message) _Static_assert((predicate), message)
+#else
+	#define PTHREADPOOL_STATIC_ASSERT(predicate, message)
+#endif
+
+static inline size_t multiply_divide(size_t a, size_t b, size_t d) {
+	#if defined(__SIZEOF_SIZE_T__) && (__SIZEOF_SIZE_T__ == 4)
+		return (size_t) ((((uint64_t) a) * ((uint64_t) b)) / ((uint64_t) d));
+	#elif defined(__SIZEOF_SIZE_T__) && (__SIZEOF_SIZE_T__ == 8)
+		return (size_t) ((((__uint128_t) a) * ((__uint128_t) b)) / ((__uint128_t) d));
+	#else
+		#error "Unsupported platform"
+	#endif
+}
+
+static inline size_t divide_round_up(size_t dividend, size_t divisor) {
+	if (dividend % divisor == 0) {
+		return dividend / divisor;
+	} else {
+		return dividend / divisor + 1;
+	}
+}
+
+static inline size_t min(size_t a, size_t b) {
+	return a < b ? a : b;
+}
+
+/* Rounds a tile of items up to a multiple of vector_width items */
+static inline size_t get_aligned_tile(size_t tile, size_t vector_width) {
+	return divide_round_up(tile, vector_width) * vector_width;
+}
+
+/* Returns the number of items up to the next vector boundary, if item 0 lies offset items past a vector boundary */
+static inline size_t get_aligned_head(size_t range, size_t offset, size_t vector_width) {
+	return min((vector_width - offset % vector_width) % vector_width, range);
+}
+
+/* Hints the processor that the thread is in a spin-wait loop */
+static inline void pthreadpool_spin_wait_hint(void) {
+	#if defined(__i386__) || defined(__x86_64__)
+		__asm__ __volatile__("pause");
+	#elif (defined(__arm__) && (__ARM_ARCH >= 7)) || defined(__aarch64__)
+		__asm__ __volatile__("yield");
+	#else
+		__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	#endif
+}
+
+/*
+ * Space-filling curves over a grid of tiles in 2 or 3 dimensions. The curve runs over the smallest power-of-2 cube
+ * which covers the grid, and tiles outside of the grid are skipped, so that the rank along the curve numbers the tiles
+ * of the grid without gaps. Consecutive ranks map to compact blocks of tiles.
+ */
+struct tile_curve {
+	/* The number of tiles in each dimension of the grid */
+	size_t tile_ranges[3];
+	/* The number of dimensions of the grid, 2 or 3 */
+	uint32_t dimensions;
+	/* The base-2 logarithm of the side of the power-of-2 cube which covers the grid */
+	uint32_t levels;
+	/* Whether the curve is a Hilbert curve rather than a Morton (Z-order) curve */
+	bool hilbert;
+};
+
+static inline struct tile_curve make_tile_curve(uint32_t dimensions, const size_t tile_ranges[], bool hilbert) {
+	struct tile_curve curve = { .dimensions = dimensions, .levels = 0, .hilbert = hilbert };
+	size_t max_tile_range = 1;
+	for (uint32_t d = 0; d < dimensions; d++) {
+		curve.tile_ranges[d] = tile_ranges[d];
+		if (tile_ranges[d] > max_tile_range) {
+			max_tile_range = tile_ranges[d];
+		}
+	}
+	while (((size_t) 1 << curve.levels) < max_tile_range) {
+		curve.levels += 1;
+	}
+	return curve;
+}
+
+/* Rotates the low bits bits of the value left by rotation bits */
+static inline uint32_t rotate_left_bits(uint32_t value, uint32_t rotation, uint32_t bits) {
+	rotation %= bits;
+	return ((value << rotation) | (value >> (bits - rotation))) & ((UINT32_C(1) << bits) - 1);
+}
+
+/* Returns the number of trailing set bits of the value */
+static inline uint32_t count_trailing_ones(uint32_t value) {
+	uint32_t count = 0;
+	while (value & 1) {
+		value >>= 1;
+		count += 1;
+	}
+	return count;
+}
+
+/*
+ * Returns the sub-cube at the specified position along the curve within a cube. For the Hilbert curve, entry and
+ * direction describe the orientation of the curve in the cube.
+ */
+static inline uint32_t get_curve_subcube(
+	const struct tile_curve* curve,
+	uint32_t position,
+	uint32_t entry,
+	uint32_t direction)
+{
+	if (curve->hilbert) {
+		return rotate_left_bits(position ^ (position >> 1), direction + 1, curve->dimensions) ^ entry;
+	} else {
+		return position;
+	}
+}
+
+/*
+ * Stores the coordinates of the tile with the specified rank along the curve to tile_index. The curve descends from
+ * the covering cube into one of its 2**dimensions sub-cubes per level, skipping the tiles of the sub-cubes which
+ * precede it along the curve. The Hilbert curve orders and orients the sub-cubes as in C. Hamilton, "Compact Hilbert
+ * indices" (2006). Bit d of a sub-cube selects the upper half of dimension (dimensions - 1 - d), so that the last
+ * dimension varies fastest within the smallest blocks of the Morton curve.
+ */
+static inline void locate_curve_tile(const struct tile_curve* curve, size_t rank, size_t tile_index[]) {
+	const uint32_t dimensions = curve->dimensions;
+	size_t origin[3] = { 0, 0, 0 };
+	uint32_t entry = 0;
+	uint32_t direction = 0;
+	bool inside = false;
+	for (uint32_t level = curve->levels; level != 0; level--) {
+		const size_t side = (size_t) 1 << (level - 1);
+		if (!inside) {
+			inside = true;
+			for (uint32_t d = 0; d < dimensions; d++) {
+				inside &= origin[d] + 2 * side <= curve->tile_ranges[d];
+			}
+		}
+
+		uint32_t position = 0;
+		uint32_t subcube;
+		if (inside) {
+			/* All sub-cubes of a cube inside the grid are full, and the rank selects the sub-cube directly */
+			const uint32_t shift = (level - 1) * dimensions;
+			position = (uint32_t) (rank >> shift);
+			rank &= ((size_t) 1 << shift) - 1;
+			subcube = get_curve_subcube(curve, position, entry, direction);
+		} else {
+			for (;; position++) {
+				subcube = get_curve_subcube(curve, position, entry, direction);
+				size_t subcube_tiles = 1;
+				for (uint32_t d = 0; d < dimensions; d++) {
+					const size_t start = origin[d] + ((subcube >> (dimensions - 1 - d)) & 1) * side;
+					subcube_tiles *= start < curve->tile_ranges[d] ? min(curve->tile_ranges[d] - start, side) : 0;
+				}
+				if (rank < subcube_tiles) {
+					break;
+				}
+				rank -= subcube_tiles;
+			}
+		}
+
+		for (uint32_t d = 0; d < dimensions; d++) {
+			origin[d] += ((subcube >> (dimensions - 1 - d)) & 1) * side;
+		}
+		if (curve->hilbert) {
+			/* Orientation of the curve in the sub-cube: its entry point and direction relative to the cube */
+			const uint32_t entry_position = position == 0 ? 0 : (position - 1) & ~UINT32_C(1);
+			const uint32_t subcube_entry = entry_position ^ (entry_position >> 1);
+			const uint32_t subcube_direction = position == 0 ? 0 :
+				count_trailing_ones((position & 1) != 0 ? position : position - 1) % dimensions;
+			entry ^= rotate_left_bits(subcube_entry, direction + 1, dimensions);
+			direction = (direction + subcube_direction + 1) % dimensions;
+		}
+	}
+	for (uint32_t d = 0; d < dimensions; d++) {
+		tile_index[d] = origin[d];
+	}
+}
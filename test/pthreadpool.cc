@@ -1,6 +1,18 @@
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <pthreadpool.h>
+#include <pthreadpool.hpp>
 
 const size_t itemsCount1D = 1024;
 
@@ -82,6 +94,24 @@ TEST(Compute1D, EachItemProcessedMultipleTimes) {
 	pthreadpool_destroy(threadpool);
 }
 
+TEST(Compute1D, EachItemProcessedMultipleTimesWithoutSpinWait) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+	const size_t iterations = 100;
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+
+	for (size_t iteration = 0; iteration < iterations; iteration++) {
+		pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	}
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(iterations, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
 static void workImbalance1D(volatile size_t* computedItems, size_t itemId) {
 	__sync_fetch_and_add(computedItems, 1);
 	if (itemId == 0) {
@@ -97,6 +127,12 @@ TEST(Compute1D, WorkStealing) {
 
 	pthreadpool* threadpool = pthreadpool_create(0);
 	EXPECT_TRUE(threadpool != nullptr);
+	if (pthreadpool_get_threads_count(threadpool) < 2) {
+		/* Item 0 blocks until all other items are done, which requires at least one other thread */
+		pthreadpool_destroy(threadpool);
+		threadpool = pthreadpool_create(2);
+		EXPECT_TRUE(threadpool != nullptr);
+	}
 
 	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(workImbalance1D), reinterpret_cast<void*>(const_cast<size_t*>(&computedItems)), itemsCount1D);
 	EXPECT_EQ(computedItems, itemsCount1D);
@@ -104,6 +140,1832 @@ TEST(Compute1D, WorkStealing) {
 	pthreadpool_destroy(threadpool);
 }
 
+TEST(CreateWithAttributes, Defaults) {
+	pthreadpool* threadpool = pthreadpool_create_with_attributes(nullptr);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CreateWithAttributes, EmptyCPUListRejected) {
+	pthreadpool_attributes attributes = { 0 };
+	attributes.affinity = pthreadpool_affinity_cpus;
+	EXPECT_TRUE(pthreadpool_create_with_attributes(&attributes) == nullptr);
+	EXPECT_EQ(EINVAL, errno);
+}
+
+TEST(CreateWithAttributes, BindToCPUList) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	/* CPU 0 is reused by all threads; the non-existent processor leaves its thread unbound */
+	const uint32_t cpus[2] = { 0, UINT32_C(1000000) };
+	pthreadpool_attributes attributes = { 0 };
+	attributes.threads_count = 4;
+	attributes.affinity = pthreadpool_affinity_cpus;
+	attributes.cpus = cpus;
+	attributes.cpus_count = 2;
+	pthreadpool* threadpool = pthreadpool_create_with_attributes(&attributes);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(4, pthreadpool_get_threads_count(threadpool));
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CreateWithAttributes, BindToPhysicalCores) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool_attributes attributes = { 0 };
+	attributes.affinity = pthreadpool_affinity_physical_cores;
+	pthreadpool* threadpool = pthreadpool_create_with_attributes(&attributes);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+struct CallerContext {
+	pthread_t callerThread;
+	bool callerProcessedItems;
+};
+
+static void waitForCaller1D(CallerContext* context, size_t itemId) {
+	if (pthread_equal(pthread_self(), context->callerThread)) {
+		__atomic_store_n(&context->callerProcessedItems, true, __ATOMIC_RELEASE);
+	} else {
+		/* Worker thread can't complete the items unless the calling thread processes items too */
+		while (!__atomic_load_n(&context->callerProcessedItems, __ATOMIC_ACQUIRE)) {
+			sched_yield();
+		}
+	}
+}
+
+TEST(Compute1D, CallerThreadParticipates) {
+	CallerContext context = { pthread_self(), false };
+
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(waitForCaller1D), &context, itemsCount1D);
+	EXPECT_TRUE(context.callerProcessedItems);
+	pthreadpool_destroy(threadpool);
+}
+
+static void checkNotCaller1D(CallerContext* context, size_t itemId) {
+	if (pthread_equal(pthread_self(), context->callerThread)) {
+		__atomic_store_n(&context->callerProcessedItems, true, __ATOMIC_RELAXED);
+	}
+}
+
+TEST(Compute1D, DedicatedWorkersOnly) {
+	CallerContext context = { pthread_self(), false };
+
+	pthreadpool_attributes attributes = { 0 };
+	attributes.threads_count = 2;
+	attributes.flags = PTHREADPOOL_FLAG_DEDICATED_WORKERS;
+	pthreadpool* threadpool = pthreadpool_create_with_attributes(&attributes);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(checkNotCaller1D), &context, itemsCount1D);
+	EXPECT_FALSE(context.callerProcessedItems);
+
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+struct ThreadsContext {
+	pthread_mutex_t mutex;
+	std::set<pthread_t> threads;
+};
+
+static void recordThread1D(ThreadsContext* context, size_t) {
+	pthread_mutex_lock(&context->mutex);
+	context->threads.insert(pthread_self());
+	pthread_mutex_unlock(&context->mutex);
+}
+
+TEST(Compute1D, WithMaxThreads) {
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t maxThreads = 1; maxThreads <= 4; maxThreads++) {
+		ThreadsContext context = { PTHREAD_MUTEX_INITIALIZER };
+		pthreadpool_compute_1d_with_max_threads(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(recordThread1D), &context, itemsCount1D, maxThreads);
+		EXPECT_LE(context.threads.size(), maxThreads);
+	}
+
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+	pthreadpool_compute_1d_with_max_threads(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D, 2);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DWithGrain, EachItemProcessedOnce) {
+	int processedCount[itemsCount1D];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	const size_t grains[] = { PTHREADPOOL_GRAIN_AUTO, 1, 7, itemsCount1D - 1, itemsCount1D, 4 * itemsCount1D };
+	for (size_t grain : grains) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_1d_with_grain(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D, grain);
+		for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with grain " << grain;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t itemsCount1DTiled = 1027;
+const size_t tileSize1DTiled = 8;
+
+static void increment1DTiled(int counters[], size_t start, size_t tile) {
+	EXPECT_LE(tile, tileSize1DTiled);
+	for (size_t itemId = start; itemId < start + tile; itemId++) {
+		counters[itemId] += 1;
+	}
+}
+
+TEST(Compute1DTiled, EachItemProcessedOnce) {
+	int processedCount[itemsCount1DTiled];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d_tiled(threadpool, reinterpret_cast<pthreadpool_function_1d_tiled_t>(increment1DTiled), processedCount, itemsCount1DTiled, tileSize1DTiled);
+	for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t vectorWidth1DTiledAligned = 16;
+const size_t offsets1DTiledAligned[] = { 0, 1, 15 };
+
+struct AlignedTilesContext {
+	int processedCount[itemsCount1DTiled];
+	size_t offset;
+	size_t misalignedTiles;
+};
+
+static void checkAlignedTile1D(AlignedTilesContext* context, size_t start, size_t tile) {
+	const bool isHead = start == 0 && context->offset != 0;
+	const bool isLast = start + tile == itemsCount1DTiled;
+	if (isHead) {
+		if ((context->offset + tile) % vectorWidth1DTiledAligned != 0 && !isLast) {
+			__atomic_fetch_add(&context->misalignedTiles, 1, __ATOMIC_RELAXED);
+		}
+	} else if ((context->offset + start) % vectorWidth1DTiledAligned != 0 ||
+		(tile % vectorWidth1DTiledAligned != 0 && !isLast) || tile > 2 * vectorWidth1DTiledAligned)
+	{
+		__atomic_fetch_add(&context->misalignedTiles, 1, __ATOMIC_RELAXED);
+	}
+	for (size_t itemId = start; itemId < start + tile; itemId++) {
+		__atomic_fetch_add(&context->processedCount[itemId], 1, __ATOMIC_RELAXED);
+	}
+}
+
+static void checkAlignedTiles1D(pthreadpool_t threadpool, uint32_t flags) {
+	for (size_t offset : offsets1DTiledAligned) {
+		AlignedTilesContext context;
+		memset(&context, 0, sizeof(context));
+		context.offset = offset;
+		/* The tile is rounded up to two vectors */
+		pthreadpool_compute_1d_tiled_aligned_with_flags(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_tiled_t>(checkAlignedTile1D), &context,
+			itemsCount1DTiled, vectorWidth1DTiledAligned + 1, offset, vectorWidth1DTiledAligned, flags);
+		EXPECT_EQ(0, context.misalignedTiles) << "with offset " << offset << " and flags " << flags;
+		for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+			EXPECT_EQ(1, context.processedCount[itemId]) << "Item " << itemId << " processed " <<
+				context.processedCount[itemId] << " times with offset " << offset << " and flags " << flags;
+		}
+	}
+}
+
+TEST(Compute1DTiledAligned, SingleThreadPoolTilesAligned) {
+	checkAlignedTiles1D(nullptr, 0);
+}
+
+TEST(Compute1DTiledAligned, MultiThreadPoolTilesAligned) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	checkAlignedTiles1D(threadpool, 0);
+	checkAlignedTiles1D(threadpool, PTHREADPOOL_FLAG_SCHEDULE_GUIDED);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DTiledAligned, HeadSpansShortRange) {
+	size_t calls = 0;
+	size_t items = 0;
+	pthreadpool_compute_1d_tiled_aligned(nullptr,
+		[&](size_t start, size_t tile) {
+			EXPECT_EQ(0, start);
+			calls += 1;
+			items += tile;
+		}, 5, 64, 3, vectorWidth1DTiledAligned);
+	EXPECT_EQ(1, calls);
+	EXPECT_EQ(5, items);
+}
+
+const size_t itemsCount2DI = 37;
+const size_t itemsCount2DJ = 43;
+
+static void increment2D(int counters[], size_t i, size_t j) {
+	counters[i * itemsCount2DJ + j] += 1;
+}
+
+TEST(Submit1D, EachItemProcessedOnce) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	const pthreadpool_completion_t completion = pthreadpool_submit_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	pthreadpool_wait(threadpool, completion);
+	EXPECT_TRUE(pthreadpool_test(threadpool, completion));
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Submit1D, DestroyWaitsForCompletion) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_submit_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	pthreadpool_destroy(threadpool);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+/* More than fit into the job slots of a thread pool */
+const size_t submittedFunctionsCount = 50;
+
+static void count1D(size_t* processedItems, size_t) {
+	__atomic_add_fetch(processedItems, 1, __ATOMIC_RELAXED);
+}
+
+TEST(Submit1D, AllSubmittedFunctionsComplete) {
+	size_t processedItems[submittedFunctionsCount];
+	memset(processedItems, 0, sizeof(processedItems));
+	pthreadpool_completion_t completions[submittedFunctionsCount];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t functionId = 0; functionId < submittedFunctionsCount; functionId++) {
+		completions[functionId] = pthreadpool_submit_1d(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(count1D), &processedItems[functionId], itemsCount1D);
+	}
+	for (size_t functionId = 0; functionId < submittedFunctionsCount; functionId++) {
+		pthreadpool_wait(threadpool, completions[functionId]);
+		EXPECT_TRUE(pthreadpool_test(threadpool, completions[functionId]));
+		EXPECT_EQ(itemsCount1D, __atomic_load_n(&processedItems[functionId], __ATOMIC_RELAXED));
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void waitForRelease1D(bool* released, size_t) {
+	while (!__atomic_load_n(released, __ATOMIC_ACQUIRE)) {
+		sched_yield();
+	}
+}
+
+TEST(Compute1D, NotBlockedBySubmittedFunction) {
+	bool released = false;
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	/* Occupies the worker thread until the synchronous call returns */
+	const pthreadpool_completion_t completion = pthreadpool_submit_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(waitForRelease1D), &released, itemsCount1D);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	__atomic_store_n(&released, true, __ATOMIC_RELEASE);
+	pthreadpool_wait(threadpool, completion);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t concurrentCallersCount = 4;
+const size_t concurrentCallsCount = 100;
+
+struct ConcurrentCaller {
+	pthreadpool* threadpool;
+	size_t processedItems;
+};
+
+static void* callConcurrently1D(void* argument) {
+	ConcurrentCaller* caller = static_cast<ConcurrentCaller*>(argument);
+	for (size_t callId = 0; callId < concurrentCallsCount; callId++) {
+		pthreadpool_compute_1d(caller->threadpool, reinterpret_cast<pthreadpool_function_1d_t>(count1D),
+			&caller->processedItems, itemsCount1D);
+	}
+	return nullptr;
+}
+
+TEST(Compute1D, ConcurrentCallers) {
+	pthread_t threads[concurrentCallersCount];
+	ConcurrentCaller callers[concurrentCallersCount];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t callerId = 0; callerId < concurrentCallersCount; callerId++) {
+		callers[callerId] = ConcurrentCaller { threadpool, 0 };
+		ASSERT_EQ(0, pthread_create(&threads[callerId], NULL, callConcurrently1D, &callers[callerId]));
+	}
+	for (size_t callerId = 0; callerId < concurrentCallersCount; callerId++) {
+		pthread_join(threads[callerId], NULL);
+		EXPECT_EQ(concurrentCallsCount * itemsCount1D, callers[callerId].processedItems);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Submit1DWithFlags, HighPriorityEachItemProcessedOnce) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	const pthreadpool_completion_t completion = pthreadpool_submit_1d_with_flags(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D, PTHREADPOOL_FLAG_PRIORITY_HIGH);
+	pthreadpool_wait(threadpool, completion);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+struct BlockerContext {
+	size_t blockedThreads;
+	bool released;
+};
+
+static void blockUntilRelease1D(BlockerContext* context, size_t) {
+	__atomic_add_fetch(&context->blockedThreads, 1, __ATOMIC_RELEASE);
+	while (!__atomic_load_n(&context->released, __ATOMIC_ACQUIRE)) {
+		sched_yield();
+	}
+}
+
+/* Submits a function which occupies the worker threads until released, and waits until it blocks all of them */
+static pthreadpool_completion_t blockWorkerThreads(pthreadpool* threadpool, BlockerContext* context, size_t workersCount) {
+	const pthreadpool_completion_t blocker = pthreadpool_submit_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(blockUntilRelease1D), context, workersCount);
+	while (__atomic_load_n(&context->blockedThreads, __ATOMIC_ACQUIRE) != workersCount) {
+		sched_yield();
+	}
+	return blocker;
+}
+
+struct PriorityContext {
+	/* The number of started items of the high-priority function */
+	size_t highPriorityItems;
+	/* The lowest number of started high-priority items observed by an item of the normal-priority function */
+	size_t highPriorityItemsBeforeNormal;
+};
+
+static void countHighPriority1D(PriorityContext* context, size_t) {
+	__atomic_add_fetch(&context->highPriorityItems, 1, __ATOMIC_RELAXED);
+}
+
+static void checkNormalPriority1D(PriorityContext* context, size_t) {
+	const size_t highPriorityItems = __atomic_load_n(&context->highPriorityItems, __ATOMIC_RELAXED);
+	size_t lowest = __atomic_load_n(&context->highPriorityItemsBeforeNormal, __ATOMIC_RELAXED);
+	while (highPriorityItems < lowest &&
+		!__atomic_compare_exchange_n(&context->highPriorityItemsBeforeNormal, &lowest, highPriorityItems,
+			true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+TEST(Submit1DWithFlags, HighPriorityFunctionProcessedFirst) {
+	const size_t workersCount = 3;
+	BlockerContext blockerContext = { 0, false };
+	PriorityContext context = { 0, SIZE_MAX };
+
+	pthreadpool* threadpool = pthreadpool_create(workersCount + 1);
+	EXPECT_TRUE(threadpool != nullptr);
+	/* Both functions below are submitted before workers look for work */
+	const pthreadpool_completion_t blocker = blockWorkerThreads(threadpool, &blockerContext, workersCount);
+	const pthreadpool_completion_t normalPriority = pthreadpool_submit_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(checkNormalPriority1D), &context, itemsCount1D);
+	const pthreadpool_completion_t highPriority = pthreadpool_submit_1d_with_flags(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(countHighPriority1D), &context, itemsCount1D, PTHREADPOOL_FLAG_PRIORITY_HIGH);
+	__atomic_store_n(&blockerContext.released, true, __ATOMIC_RELEASE);
+	pthreadpool_wait(threadpool, highPriority);
+	pthreadpool_wait(threadpool, normalPriority);
+	pthreadpool_wait(threadpool, blocker);
+
+	/*
+	 * Workers take normal-priority items only after all high-priority items are taken:
+	 * by then, only the items which other workers took and did not start yet may be left.
+	 */
+	EXPECT_GE(context.highPriorityItemsBeforeNormal + (workersCount - 1), itemsCount1D);
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t cancellingItem = 100;
+
+static int findItem1D(size_t* processedItems, size_t itemId) {
+	__atomic_add_fetch(processedItems, 1, __ATOMIC_RELAXED);
+	return itemId == cancellingItem;
+}
+
+static int findNothing1D(size_t* processedItems, size_t) {
+	__atomic_add_fetch(processedItems, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+TEST(Compute1DCancellable, SingleThreadPoolStopsAfterCancellingItem) {
+	size_t processedItems = 0;
+
+	pthreadpool* threadpool = pthreadpool_create(1);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_NE(0, pthreadpool_compute_1d_cancellable(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_cancellable_t>(findItem1D), &processedItems, itemsCount1D));
+	EXPECT_EQ(cancellingItem + 1, processedItems);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DCancellable, CallerStopsAfterCancellingItem) {
+	BlockerContext blockerContext = { 0, false };
+	size_t processedItems = 0;
+
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	/* With the worker thread blocked, the calling thread processes the items in order */
+	const pthreadpool_completion_t blocker = blockWorkerThreads(threadpool, &blockerContext, 1);
+	EXPECT_NE(0, pthreadpool_compute_1d_cancellable(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_cancellable_t>(findItem1D), &processedItems, itemsCount1D));
+	EXPECT_EQ(cancellingItem + 1, processedItems);
+	__atomic_store_n(&blockerContext.released, true, __ATOMIC_RELEASE);
+	pthreadpool_wait(threadpool, blocker);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DCancellable, AllItemsProcessedWithoutCancellation) {
+	size_t processedItems = 0;
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(0, pthreadpool_compute_1d_cancellable(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_cancellable_t>(findNothing1D), &processedItems, itemsCount1D));
+	EXPECT_EQ(itemsCount1D, processedItems);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DCancellable, RepeatedCancellation) {
+	size_t processedItems = 0;
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t call = 0; call < 100; call++) {
+		processedItems = 0;
+		EXPECT_NE(0, pthreadpool_compute_1d_cancellable(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_cancellable_t>(findItem1D), &processedItems, itemsCount1D));
+		EXPECT_NE(0, processedItems);
+		EXPECT_GE(itemsCount1D, processedItems);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static int findTile1D(size_t* processedItems, size_t start, size_t tile) {
+	__atomic_add_fetch(processedItems, tile, __ATOMIC_RELAXED);
+	return start <= cancellingItem && cancellingItem < start + tile;
+}
+
+TEST(Compute1DTiledCancellable, StopsAfterCancellingTile) {
+	size_t processedItems = 0;
+
+	EXPECT_NE(0, pthreadpool_compute_1d_tiled_cancellable(nullptr,
+		reinterpret_cast<pthreadpool_function_1d_tiled_cancellable_t>(findTile1D), &processedItems, itemsCount1DTiled, tileSize1DTiled));
+	EXPECT_EQ((cancellingItem / tileSize1DTiled + 1) * tileSize1DTiled, processedItems);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	processedItems = 0;
+	EXPECT_NE(0, pthreadpool_compute_1d_tiled_cancellable(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_tiled_cancellable_t>(findTile1D), &processedItems, itemsCount1DTiled, tileSize1DTiled));
+	EXPECT_GE(itemsCount1DTiled, processedItems);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Submit1D, CancelledFunctionSkipsItems) {
+	BlockerContext blockerContext = { 0, false };
+	size_t processedItems = 0;
+
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	/* No thread takes items of the function until the worker thread is released */
+	const pthreadpool_completion_t blocker = blockWorkerThreads(threadpool, &blockerContext, 1);
+	const pthreadpool_completion_t completion = pthreadpool_submit_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(count1D), &processedItems, itemsCount1D);
+	pthreadpool_cancel(threadpool, completion);
+	__atomic_store_n(&blockerContext.released, true, __ATOMIC_RELEASE);
+	pthreadpool_wait(threadpool, completion);
+	pthreadpool_wait(threadpool, blocker);
+	EXPECT_TRUE(pthreadpool_test(threadpool, completion));
+	EXPECT_EQ(0, processedItems);
+
+	/* Cancelling a completed function has no effect on later functions */
+	pthreadpool_cancel(threadpool, completion);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(count1D), &processedItems, itemsCount1D);
+	EXPECT_EQ(itemsCount1D, processedItems);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute2D, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_2d(threadpool, reinterpret_cast<pthreadpool_function_2d_t>(increment2D), processedCount, itemsCount2DI, itemsCount2DJ);
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute2DWithGrain, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	const size_t grains[] = { PTHREADPOOL_GRAIN_AUTO, 1, itemsCount2DJ + 1 };
+	for (size_t grain : grains) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_2d_with_grain(threadpool, reinterpret_cast<pthreadpool_function_2d_t>(increment2D),
+			processedCount, itemsCount2DI, itemsCount2DJ, grain);
+		for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with grain " << grain;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static pthreadpool_completion_t submitIncrement2D(pthreadpool* threadpool, int processedCount[]) {
+	/* The call must preserve the adapter context after this stack frame is gone */
+	return pthreadpool_submit_2d(threadpool, reinterpret_cast<pthreadpool_function_2d_t>(increment2D), processedCount,
+		itemsCount2DI, itemsCount2DJ);
+}
+
+TEST(Submit2D, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	const pthreadpool_completion_t completion = submitIncrement2D(threadpool, processedCount);
+	pthreadpool_wait(threadpool, completion);
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t tileSize2DI = 4;
+const size_t tileSize2DJ = 5;
+
+static void increment2DTiled(int counters[], size_t start_i, size_t start_j, size_t tile_i, size_t tile_j) {
+	EXPECT_LE(tile_i, tileSize2DI);
+	EXPECT_LE(tile_j, tileSize2DJ);
+	for (size_t i = start_i; i < start_i + tile_i; i++) {
+		for (size_t j = start_j; j < start_j + tile_j; j++) {
+			counters[i * itemsCount2DJ + j] += 1;
+		}
+	}
+}
+
+TEST(Compute2DTiled, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_2d_tiled(threadpool, reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled), processedCount, itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ);
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t itemsCount3DI = 7;
+const size_t itemsCount3DJ = 11;
+const size_t itemsCount3DK = 13;
+
+static void increment3D(int counters[], size_t i, size_t j, size_t k) {
+	counters[(i * itemsCount3DJ + j) * itemsCount3DK + k] += 1;
+}
+
+TEST(Compute3D, EachItemProcessedOnce) {
+	int processedCount[itemsCount3DI * itemsCount3DJ * itemsCount3DK];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_3d(threadpool, reinterpret_cast<pthreadpool_function_3d_t>(increment3D), processedCount, itemsCount3DI, itemsCount3DJ, itemsCount3DK);
+	for (size_t itemId = 0; itemId < itemsCount3DI * itemsCount3DJ * itemsCount3DK; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t tileSize3DI = 2;
+const size_t tileSize3DJ = 3;
+const size_t tileSize3DK = 4;
+
+static void increment3DTiled(int counters[], size_t start_i, size_t start_j, size_t start_k, size_t tile_i, size_t tile_j, size_t tile_k) {
+	EXPECT_LE(tile_i, tileSize3DI);
+	EXPECT_LE(tile_j, tileSize3DJ);
+	EXPECT_LE(tile_k, tileSize3DK);
+	for (size_t i = start_i; i < start_i + tile_i; i++) {
+		for (size_t j = start_j; j < start_j + tile_j; j++) {
+			for (size_t k = start_k; k < start_k + tile_k; k++) {
+				counters[(i * itemsCount3DJ + j) * itemsCount3DK + k] += 1;
+			}
+		}
+	}
+}
+
+TEST(Compute3DTiled, EachItemProcessedOnce) {
+	int processedCount[itemsCount3DI * itemsCount3DJ * itemsCount3DK];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_3d_tiled(threadpool, reinterpret_cast<pthreadpool_function_3d_tiled_t>(increment3DTiled), processedCount,
+		itemsCount3DI, itemsCount3DJ, itemsCount3DK, tileSize3DI, tileSize3DJ, tileSize3DK);
+	for (size_t itemId = 0; itemId < itemsCount3DI * itemsCount3DJ * itemsCount3DK; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t itemsCountND[6] = { 3, 2, 4, 3, 7, 9 };
+const size_t tileSizeNDInner = 2;
+const size_t tileSizeNDInnermost = 4;
+
+static size_t itemIndexND(const size_t index[], size_t dimensions) {
+	size_t linearIndex = 0;
+	for (size_t dimension = 0; dimension < dimensions; dimension++) {
+		linearIndex = linearIndex * itemsCountND[dimension] + index[dimension];
+	}
+	return linearIndex;
+}
+
+static void incrementTileND(int counters[], size_t dimensions, size_t index[], size_t tile_inner, size_t tile_innermost) {
+	EXPECT_LE(tile_inner, tileSizeNDInner);
+	EXPECT_LE(tile_innermost, tileSizeNDInnermost);
+	const size_t start_inner = index[dimensions - 2];
+	const size_t start_innermost = index[dimensions - 1];
+	for (size_t inner = start_inner; inner < start_inner + tile_inner; inner++) {
+		for (size_t innermost = start_innermost; innermost < start_innermost + tile_innermost; innermost++) {
+			index[dimensions - 2] = inner;
+			index[dimensions - 1] = innermost;
+			counters[itemIndexND(index, dimensions)] += 1;
+		}
+	}
+}
+
+static void increment4DTiled(int counters[], size_t i, size_t j, size_t k, size_t l, size_t tile_k, size_t tile_l) {
+	size_t index[4] = { i, j, k, l };
+	incrementTileND(counters, 4, index, tile_k, tile_l);
+}
+
+static void increment5DTiled(int counters[], size_t i, size_t j, size_t k, size_t l, size_t m, size_t tile_l, size_t tile_m) {
+	size_t index[5] = { i, j, k, l, m };
+	incrementTileND(counters, 5, index, tile_l, tile_m);
+}
+
+static void increment6DTiled(int counters[], size_t i, size_t j, size_t k, size_t l, size_t m, size_t n, size_t tile_m, size_t tile_n) {
+	size_t index[6] = { i, j, k, l, m, n };
+	incrementTileND(counters, 6, index, tile_m, tile_n);
+}
+
+static void checkEachItemProcessedOnceND(const int processedCount[], size_t dimensions) {
+	size_t itemsCount = 1;
+	for (size_t dimension = 0; dimension < dimensions; dimension++) {
+		itemsCount *= itemsCountND[dimension];
+	}
+	for (size_t itemId = 0; itemId < itemsCount; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+TEST(Compute4DTiled, EachItemProcessedOnce) {
+	int processedCount[3 * 2 * 4 * 3];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_4d_tiled(threadpool, reinterpret_cast<pthreadpool_function_4d_tiled_t>(increment4DTiled), processedCount,
+		itemsCountND[0], itemsCountND[1], itemsCountND[2], itemsCountND[3], tileSizeNDInner, tileSizeNDInnermost);
+	checkEachItemProcessedOnceND(processedCount, 4);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute5DTiled, EachItemProcessedOnce) {
+	int processedCount[3 * 2 * 4 * 3 * 7];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_5d_tiled(threadpool, reinterpret_cast<pthreadpool_function_5d_tiled_t>(increment5DTiled), processedCount,
+		itemsCountND[0], itemsCountND[1], itemsCountND[2], itemsCountND[3], itemsCountND[4], tileSizeNDInner, tileSizeNDInnermost);
+	checkEachItemProcessedOnceND(processedCount, 5);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute6DTiled, EachItemProcessedOnce) {
+	int processedCount[3 * 2 * 4 * 3 * 7 * 9];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_6d_tiled(threadpool, reinterpret_cast<pthreadpool_function_6d_tiled_t>(increment6DTiled), processedCount,
+		itemsCountND[0], itemsCountND[1], itemsCountND[2], itemsCountND[3], itemsCountND[4], itemsCountND[5], tileSizeNDInner, tileSizeNDInnermost);
+	checkEachItemProcessedOnceND(processedCount, 6);
+	pthreadpool_destroy(threadpool);
+}
+
+const size_t scratchSize2DTiled = 1000;
+
+struct ScratchContext2DTiled {
+	int* processedCount;
+	size_t threadsCount;
+};
+
+static void incrementWithScratch2DTiled(ScratchContext2DTiled* context, size_t threadNumber, void* scratch,
+	size_t start_i, size_t start_j, size_t tile_i, size_t tile_j)
+{
+	EXPECT_LT(threadNumber, context->threadsCount);
+	ASSERT_TRUE(scratch != nullptr);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(scratch) % 64);
+
+	/* No other thread may use this scratch memory concurrently */
+	volatile size_t* marker = static_cast<volatile size_t*>(scratch);
+	marker[0] = threadNumber;
+	marker[scratchSize2DTiled / sizeof(size_t) - 1] = threadNumber;
+	for (size_t i = start_i; i < start_i + tile_i; i++) {
+		for (size_t j = start_j; j < start_j + tile_j; j++) {
+			context->processedCount[i * itemsCount2DJ + j] += 1;
+		}
+	}
+	EXPECT_EQ(threadNumber, marker[0]);
+	EXPECT_EQ(threadNumber, marker[scratchSize2DTiled / sizeof(size_t) - 1]);
+}
+
+TEST(Compute2DTiledWithScratch, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	ScratchContext2DTiled context = { processedCount, pthreadpool_get_threads_count(threadpool) };
+	EXPECT_EQ(0, pthreadpool_compute_2d_tiled_with_scratch(threadpool,
+		reinterpret_cast<pthreadpool_function_2d_tiled_with_scratch_t>(incrementWithScratch2DTiled), &context,
+		itemsCount2DI, itemsCount2DJ, 1, 1, scratchSize2DTiled));
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void fillScratch2DTiled(void*, size_t, void* scratch, size_t, size_t, size_t, size_t) {
+	memset(scratch, 0xA5, scratchSize2DTiled * 4);
+}
+
+TEST(Compute2DTiledWithScratch, ScratchGrows) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	ScratchContext2DTiled context = { nullptr, pthreadpool_get_threads_count(threadpool) };
+	int processedCount[itemsCount2DI * itemsCount2DJ] = { 0 };
+	context.processedCount = processedCount;
+	EXPECT_EQ(0, pthreadpool_compute_2d_tiled_with_scratch(threadpool,
+		reinterpret_cast<pthreadpool_function_2d_tiled_with_scratch_t>(incrementWithScratch2DTiled), &context,
+		itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ, scratchSize2DTiled));
+	EXPECT_EQ(0, pthreadpool_compute_2d_tiled_with_scratch(threadpool, fillScratch2DTiled, nullptr,
+		itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ, scratchSize2DTiled * 4));
+	pthreadpool_destroy(threadpool);
+}
+
+const uint32_t scheduleFlags[] = {
+	PTHREADPOOL_FLAG_SCHEDULE_DYNAMIC,
+	PTHREADPOOL_FLAG_SCHEDULE_STATIC,
+	PTHREADPOOL_FLAG_SCHEDULE_GUIDED,
+};
+
+TEST(Compute1DWithFlags, EachItemProcessedOnce) {
+	int processedCount[itemsCount1D];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t flags : scheduleFlags) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_1d_with_flags(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D, flags);
+		for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with flags " << flags;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute1DTiledWithFlags, EachItemProcessedOnce) {
+	int processedCount[itemsCount1DTiled];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t flags : scheduleFlags) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_1d_tiled_with_flags(threadpool, reinterpret_cast<pthreadpool_function_1d_tiled_t>(increment1DTiled),
+			processedCount, itemsCount1DTiled, tileSize1DTiled, flags);
+		for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with flags " << flags;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute2DWithFlags, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t flags : scheduleFlags) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_2d_with_flags(threadpool, reinterpret_cast<pthreadpool_function_2d_t>(increment2D),
+			processedCount, itemsCount2DI, itemsCount2DJ, flags);
+		for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with flags " << flags;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Compute2DTiledWithFlags, EachItemProcessedOnce) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t flags : scheduleFlags) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_2d_tiled_with_flags(threadpool, reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled),
+			processedCount, itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ, flags);
+		for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times with flags " << flags;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+const uint32_t traversalFlags[] = {
+	PTHREADPOOL_FLAG_TRAVERSAL_ROW_MAJOR,
+	PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR,
+	PTHREADPOOL_FLAG_TRAVERSAL_MORTON,
+	PTHREADPOOL_FLAG_TRAVERSAL_HILBERT,
+};
+
+TEST(Compute2DTiledWithFlags, EachItemProcessedOnceInEachTraversal) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t traversal : traversalFlags) {
+		for (uint32_t schedule : scheduleFlags) {
+			const uint32_t flags = traversal | schedule;
+			memset(processedCount, 0, sizeof(processedCount));
+			pthreadpool_compute_2d_tiled_with_flags(threadpool, reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled),
+				processedCount, itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ, flags);
+			for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+				EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+					" times with flags " << flags;
+			}
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void recordTile2D(std::vector<std::pair<size_t, size_t>>* tiles, size_t start_i, size_t start_j, size_t, size_t) {
+	tiles->push_back(std::make_pair(start_i, start_j));
+}
+
+static std::vector<std::pair<size_t, size_t>> getTileOrder2D(uint32_t flags) {
+	std::vector<std::pair<size_t, size_t>> tiles;
+	/* Without a thread pool, tiles are processed one by one in the traversal order */
+	pthreadpool_compute_2d_tiled_with_flags(nullptr, reinterpret_cast<pthreadpool_function_2d_tiled_t>(recordTile2D),
+		&tiles, 8, 8, 1, 1, flags);
+	return tiles;
+}
+
+TEST(Compute2DTiledWithFlags, ColumnMajorTraversal) {
+	const std::vector<std::pair<size_t, size_t>> tiles = getTileOrder2D(PTHREADPOOL_FLAG_TRAVERSAL_COLUMN_MAJOR);
+	ASSERT_EQ(64, tiles.size());
+	for (size_t t = 0; t < tiles.size(); t++) {
+		EXPECT_EQ(t % 8, tiles[t].first);
+		EXPECT_EQ(t / 8, tiles[t].second);
+	}
+}
+
+TEST(Compute2DTiledWithFlags, MortonTraversal) {
+	const std::vector<std::pair<size_t, size_t>> tiles = getTileOrder2D(PTHREADPOOL_FLAG_TRAVERSAL_MORTON);
+	ASSERT_EQ(64, tiles.size());
+	/* Each aligned run of 4^n tiles covers a 2^n x 2^n block */
+	for (size_t blockSize = 2; blockSize <= 8; blockSize *= 2) {
+		for (size_t t = 0; t < tiles.size(); t += blockSize * blockSize) {
+			for (size_t u = t; u < t + blockSize * blockSize; u++) {
+				EXPECT_EQ(tiles[t].first / blockSize, tiles[u].first / blockSize);
+				EXPECT_EQ(tiles[t].second / blockSize, tiles[u].second / blockSize);
+			}
+		}
+	}
+}
+
+TEST(Compute2DTiledWithFlags, HilbertTraversal) {
+	const std::vector<std::pair<size_t, size_t>> tiles = getTileOrder2D(PTHREADPOOL_FLAG_TRAVERSAL_HILBERT);
+	ASSERT_EQ(64, tiles.size());
+	const std::set<std::pair<size_t, size_t>> uniqueTiles(tiles.begin(), tiles.end());
+	EXPECT_EQ(64, uniqueTiles.size());
+	/* Consecutive tiles are neighbours */
+	for (size_t t = 1; t < tiles.size(); t++) {
+		const size_t distance =
+			std::max(tiles[t].first, tiles[t - 1].first) - std::min(tiles[t].first, tiles[t - 1].first) +
+			std::max(tiles[t].second, tiles[t - 1].second) - std::min(tiles[t].second, tiles[t - 1].second);
+		EXPECT_EQ(1, distance) << "Tiles " << t - 1 << " and " << t << " are not adjacent";
+	}
+}
+
+TEST(Compute3DTiledWithFlags, EachItemProcessedOnceInEachTraversal) {
+	int processedCount[itemsCount3DI * itemsCount3DJ * itemsCount3DK];
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (uint32_t traversal : traversalFlags) {
+		for (uint32_t schedule : scheduleFlags) {
+			const uint32_t flags = traversal | schedule;
+			memset(processedCount, 0, sizeof(processedCount));
+			pthreadpool_compute_3d_tiled_with_flags(threadpool, reinterpret_cast<pthreadpool_function_3d_tiled_t>(increment3DTiled),
+				processedCount, itemsCount3DI, itemsCount3DJ, itemsCount3DK, tileSize3DI, tileSize3DJ, tileSize3DK, flags);
+			for (size_t itemId = 0; itemId < itemsCount3DI * itemsCount3DJ * itemsCount3DK; itemId++) {
+				EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+					" times with flags " << flags;
+			}
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void sumItems1D(void*, uint64_t* accumulator, size_t i) {
+	*accumulator += i;
+}
+
+static void sumItems1DTiled(void*, uint64_t* accumulator, size_t start, size_t tile) {
+	for (size_t i = start; i < start + tile; i++) {
+		*accumulator += i;
+	}
+}
+
+static void combineSums(void*, uint64_t* accumulator, const uint64_t* other) {
+	*accumulator += *other;
+}
+
+struct MinMax {
+	size_t min;
+	size_t max;
+};
+
+static void minMaxItems1D(const size_t* values, MinMax* accumulator, size_t i) {
+	accumulator->min = std::min(accumulator->min, values[i]);
+	accumulator->max = std::max(accumulator->max, values[i]);
+}
+
+static void combineMinMax(const size_t*, MinMax* accumulator, const MinMax* other) {
+	accumulator->min = std::min(accumulator->min, other->min);
+	accumulator->max = std::max(accumulator->max, other->max);
+}
+
+TEST(Reduce1D, Sum) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (int iteration = 0; iteration < 10; iteration++) {
+		uint64_t sum = 0;
+		EXPECT_EQ(0, pthreadpool_reduce_1d(threadpool, reinterpret_cast<pthreadpool_function_reduce_1d_t>(sumItems1D),
+			reinterpret_cast<pthreadpool_function_combine_t>(combineSums), nullptr, &sum, sizeof(sum), itemsCount1D));
+		EXPECT_EQ(uint64_t(itemsCount1D) * (itemsCount1D - 1) / 2, sum);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Reduce1D, MinMax) {
+	size_t values[itemsCount1D];
+	for (size_t i = 0; i < itemsCount1D; i++) {
+		values[i] = (i * 37 + 11) % itemsCount1D + 5;
+	}
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	MinMax minMax = { SIZE_MAX, 0 };
+	EXPECT_EQ(0, pthreadpool_reduce_1d(threadpool, reinterpret_cast<pthreadpool_function_reduce_1d_t>(minMaxItems1D),
+		reinterpret_cast<pthreadpool_function_combine_t>(combineMinMax), values, &minMax, sizeof(minMax), itemsCount1D));
+	EXPECT_EQ(5, minMax.min);
+	EXPECT_EQ(itemsCount1D + 4, minMax.max);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Reduce1D, NullThreadPool) {
+	uint64_t sum = 0;
+	EXPECT_EQ(0, pthreadpool_reduce_1d(nullptr, reinterpret_cast<pthreadpool_function_reduce_1d_t>(sumItems1D),
+		reinterpret_cast<pthreadpool_function_combine_t>(combineSums), nullptr, &sum, sizeof(sum), itemsCount1D));
+	EXPECT_EQ(uint64_t(itemsCount1D) * (itemsCount1D - 1) / 2, sum);
+}
+
+TEST(Reduce1DTiled, Sum) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	uint64_t sum = 0;
+	EXPECT_EQ(0, pthreadpool_reduce_1d_tiled(threadpool, reinterpret_cast<pthreadpool_function_reduce_1d_tiled_t>(sumItems1DTiled),
+		reinterpret_cast<pthreadpool_function_combine_t>(combineSums), nullptr, &sum, sizeof(sum),
+		itemsCount1DTiled, tileSize1DTiled));
+	EXPECT_EQ(uint64_t(itemsCount1DTiled) * (itemsCount1DTiled - 1) / 2, sum);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(ComputeBatch, EachItemProcessedOnce) {
+	int processedCount1D[itemsCount1D];
+	int processedCount1DTiled[itemsCount1DTiled];
+	int processedCount2D[itemsCount2DI * itemsCount2DJ];
+	int processedCount2DTiled[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount1D, 0, sizeof(processedCount1D));
+	memset(processedCount1DTiled, 0, sizeof(processedCount1DTiled));
+	memset(processedCount2D, 0, sizeof(processedCount2D));
+	memset(processedCount2DTiled, 0, sizeof(processedCount2DTiled));
+
+	pthreadpool_loop loops[5];
+	memset(loops, 0, sizeof(loops));
+	loops[0].type = pthreadpool_loop_1d;
+	loops[0].function.function_1d = reinterpret_cast<pthreadpool_function_1d_t>(increment1D);
+	loops[0].argument = processedCount1D;
+	loops[0].range_i = itemsCount1D;
+	loops[1].type = pthreadpool_loop_2d;
+	loops[1].function.function_2d = reinterpret_cast<pthreadpool_function_2d_t>(increment2D);
+	loops[1].argument = processedCount2D;
+	loops[1].range_i = itemsCount2DI;
+	loops[1].range_j = 0;
+	loops[2].type = pthreadpool_loop_1d_tiled;
+	loops[2].function.function_1d_tiled = reinterpret_cast<pthreadpool_function_1d_tiled_t>(increment1DTiled);
+	loops[2].argument = processedCount1DTiled;
+	loops[2].range_i = itemsCount1DTiled;
+	loops[2].tile_i = tileSize1DTiled;
+	loops[3] = loops[1];
+	loops[3].range_j = itemsCount2DJ;
+	loops[4].type = pthreadpool_loop_2d_tiled;
+	loops[4].function.function_2d_tiled = reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled);
+	loops[4].argument = processedCount2DTiled;
+	loops[4].range_i = itemsCount2DI;
+	loops[4].range_j = itemsCount2DJ;
+	loops[4].tile_i = tileSize2DI;
+	loops[4].tile_j = tileSize2DJ;
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_batch(threadpool, loops, 5);
+	pthreadpool_destroy(threadpool);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount1D[itemId]) << "Item " << itemId << " processed " << processedCount1D[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+		EXPECT_EQ(1, processedCount1DTiled[itemId]) << "Item " << itemId << " processed " << processedCount1DTiled[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount2D[itemId]) << "Item " << itemId << " processed " << processedCount2D[itemId] << " times";
+		EXPECT_EQ(1, processedCount2DTiled[itemId]) << "Item " << itemId << " processed " << processedCount2DTiled[itemId] << " times";
+	}
+}
+
+TEST(ComputeBatch, ManyLoops) {
+	const size_t loopsCount = 37;
+	int processedCounts[loopsCount][itemsCount1D];
+	memset(processedCounts, 0, sizeof(processedCounts));
+
+	pthreadpool_loop loops[loopsCount];
+	memset(loops, 0, sizeof(loops));
+	for (size_t loopId = 0; loopId < loopsCount; loopId++) {
+		loops[loopId].type = pthreadpool_loop_1d;
+		loops[loopId].function.function_1d = reinterpret_cast<pthreadpool_function_1d_t>(increment1D);
+		loops[loopId].argument = processedCounts[loopId];
+		loops[loopId].range_i = (loopId * 131) % itemsCount1D;
+	}
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_batch(threadpool, loops, loopsCount);
+	pthreadpool_destroy(threadpool);
+
+	for (size_t loopId = 0; loopId < loopsCount; loopId++) {
+		for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+			const int expectedCount = itemId < loops[loopId].range_i ? 1 : 0;
+			EXPECT_EQ(expectedCount, processedCounts[loopId][itemId]) << "Item " << itemId << " of loop " << loopId <<
+				" processed " << processedCounts[loopId][itemId] << " times";
+		}
+	}
+}
+
+TEST(Plan, EachItemProcessedOnce) {
+	int processedCount1D[itemsCount1D];
+	int processedCount1DTiled[itemsCount1DTiled];
+	int processedCount2D[itemsCount2DI * itemsCount2DJ];
+	int processedCount2DTiled[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount1D, 0, sizeof(processedCount1D));
+	memset(processedCount1DTiled, 0, sizeof(processedCount1DTiled));
+	memset(processedCount2D, 0, sizeof(processedCount2D));
+	memset(processedCount2DTiled, 0, sizeof(processedCount2DTiled));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_plan_t plans[] = {
+		pthreadpool_plan_create_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), itemsCount1D),
+		pthreadpool_plan_create_1d_tiled(threadpool, reinterpret_cast<pthreadpool_function_1d_tiled_t>(increment1DTiled),
+			itemsCount1DTiled, tileSize1DTiled),
+		pthreadpool_plan_create_2d(threadpool, reinterpret_cast<pthreadpool_function_2d_t>(increment2D),
+			itemsCount2DI, itemsCount2DJ),
+		pthreadpool_plan_create_2d_tiled(threadpool, reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled),
+			itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ),
+	};
+	int* processedCounts[] = { processedCount1D, processedCount1DTiled, processedCount2D, processedCount2DTiled };
+	for (size_t planId = 0; planId < 4; planId++) {
+		EXPECT_TRUE(plans[planId] != nullptr);
+		pthreadpool_plan_execute(plans[planId], processedCounts[planId]);
+		pthreadpool_plan_destroy(plans[planId]);
+	}
+	pthreadpool_destroy(threadpool);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount1D[itemId]) << "Item " << itemId << " processed " << processedCount1D[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+		EXPECT_EQ(1, processedCount1DTiled[itemId]) << "Item " << itemId << " processed " << processedCount1DTiled[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount2D[itemId]) << "Item " << itemId << " processed " << processedCount2D[itemId] << " times";
+		EXPECT_EQ(1, processedCount2DTiled[itemId]) << "Item " << itemId << " processed " << processedCount2DTiled[itemId] << " times";
+	}
+}
+
+TEST(Plan, ArgumentChangesBetweenExecutions) {
+	int processedCounts[3][itemsCount2DI * itemsCount2DJ];
+	memset(processedCounts, 0, sizeof(processedCounts));
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_plan_t plan = pthreadpool_plan_create_2d_tiled(threadpool,
+		reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled),
+		itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ);
+	EXPECT_TRUE(plan != nullptr);
+	for (size_t execution = 0; execution < 30; execution++) {
+		pthreadpool_plan_execute(plan, processedCounts[execution % 3]);
+	}
+	pthreadpool_plan_destroy(plan);
+	pthreadpool_destroy(threadpool);
+
+	for (size_t argumentId = 0; argumentId < 3; argumentId++) {
+		for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+			EXPECT_EQ(10, processedCounts[argumentId][itemId]) << "Item " << itemId << " of argument " << argumentId <<
+				" processed " << processedCounts[argumentId][itemId] << " times";
+		}
+	}
+}
+
+TEST(Plan, ThreadsCountChanges) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_plan_t plan = pthreadpool_plan_create_1d(threadpool,
+		reinterpret_cast<pthreadpool_function_1d_t>(increment1D), itemsCount1D);
+	EXPECT_TRUE(plan != nullptr);
+	const size_t threadsCounts[] = { 4, 2, 1, 3, 4 };
+	for (size_t threadsCount : threadsCounts) {
+		EXPECT_EQ(0, pthreadpool_set_threads_count(threadpool, threadsCount));
+		pthreadpool_plan_execute(plan, processedCount);
+	}
+	pthreadpool_plan_destroy(plan);
+	pthreadpool_destroy(threadpool);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(5, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+TEST(Plan, NullThreadPool) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool_plan_t plan = pthreadpool_plan_create_1d(nullptr,
+		reinterpret_cast<pthreadpool_function_1d_t>(increment1D), itemsCount1D);
+	EXPECT_TRUE(plan != nullptr);
+	pthreadpool_plan_execute(plan, processedCount);
+	pthreadpool_plan_destroy(plan);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+TEST(Graph, EachItemProcessedOnce) {
+	int processedCount1D[itemsCount1D];
+	int processedCount1DTiled[itemsCount1DTiled];
+	int processedCount2D[itemsCount2DI * itemsCount2DJ];
+	int processedCount2DTiled[itemsCount2DI * itemsCount2DJ];
+	memset(processedCount1D, 0, sizeof(processedCount1D));
+	memset(processedCount1DTiled, 0, sizeof(processedCount1DTiled));
+	memset(processedCount2D, 0, sizeof(processedCount2D));
+	memset(processedCount2DTiled, 0, sizeof(processedCount2DTiled));
+
+	pthreadpool_graph_t graph = pthreadpool_graph_create();
+	EXPECT_TRUE(graph != nullptr);
+	size_t node;
+	EXPECT_EQ(0, pthreadpool_graph_add_1d(graph, reinterpret_cast<pthreadpool_function_1d_t>(increment1D),
+		processedCount1D, itemsCount1D, &node));
+	EXPECT_EQ(0, node);
+	EXPECT_EQ(0, pthreadpool_graph_add_1d_tiled(graph, reinterpret_cast<pthreadpool_function_1d_tiled_t>(increment1DTiled),
+		processedCount1DTiled, itemsCount1DTiled, tileSize1DTiled, &node));
+	EXPECT_EQ(1, node);
+	EXPECT_EQ(0, pthreadpool_graph_add_2d(graph, reinterpret_cast<pthreadpool_function_2d_t>(increment2D),
+		processedCount2D, itemsCount2DI, itemsCount2DJ, &node));
+	EXPECT_EQ(2, node);
+	EXPECT_EQ(0, pthreadpool_graph_add_2d_tiled(graph, reinterpret_cast<pthreadpool_function_2d_tiled_t>(increment2DTiled),
+		processedCount2DTiled, itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ, &node));
+	EXPECT_EQ(3, node);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(0, pthreadpool_graph_run(threadpool, graph));
+	pthreadpool_destroy(threadpool);
+	pthreadpool_graph_destroy(graph);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount1D[itemId]) << "Item " << itemId << " processed " << processedCount1D[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+		EXPECT_EQ(1, processedCount1DTiled[itemId]) << "Item " << itemId << " processed " << processedCount1DTiled[itemId] << " times";
+	}
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount2D[itemId]) << "Item " << itemId << " processed " << processedCount2D[itemId] << " times";
+		EXPECT_EQ(1, processedCount2DTiled[itemId]) << "Item " << itemId << " processed " << processedCount2DTiled[itemId] << " times";
+	}
+}
+
+/* Node of a test graph, which checks that the nodes it depends on completed before any of its items */
+struct GraphStage {
+	size_t items;
+	size_t processedItems;
+	size_t dependenciesCount;
+	const GraphStage* dependencies[2];
+	size_t earlyItems;
+};
+
+static void processGraphStage(GraphStage* stage, size_t) {
+	for (size_t i = 0; i < stage->dependenciesCount; i++) {
+		if (__atomic_load_n(&stage->dependencies[i]->processedItems, __ATOMIC_RELAXED) != stage->dependencies[i]->items) {
+			__atomic_add_fetch(&stage->earlyItems, 1, __ATOMIC_RELAXED);
+		}
+	}
+	__atomic_add_fetch(&stage->processedItems, 1, __ATOMIC_RELAXED);
+}
+
+TEST(Graph, DependenciesCompleteFirst) {
+	/* Diamond: 0 -> {1, 2} -> 3, followed by an empty node 4 and a node 5 which depends on it */
+	GraphStage stages[6] = {
+		{ itemsCount1D, 0, 0, { nullptr, nullptr }, 0 },
+		{ itemsCount1D, 0, 1, { &stages[0], nullptr }, 0 },
+		{ 17, 0, 1, { &stages[0], nullptr }, 0 },
+		{ itemsCount1D, 0, 2, { &stages[1], &stages[2] }, 0 },
+		{ 0, 0, 1, { &stages[3], nullptr }, 0 },
+		{ 5, 0, 2, { &stages[3], &stages[4] }, 0 },
+	};
+
+	pthreadpool_graph_t graph = pthreadpool_graph_create();
+	EXPECT_TRUE(graph != nullptr);
+	for (size_t stageId = 0; stageId < 6; stageId++) {
+		size_t node;
+		EXPECT_EQ(0, pthreadpool_graph_add_1d(graph, reinterpret_cast<pthreadpool_function_1d_t>(processGraphStage),
+			&stages[stageId], stages[stageId].items, &node));
+		EXPECT_EQ(stageId, node);
+		for (size_t i = 0; i < stages[stageId].dependenciesCount; i++) {
+			EXPECT_EQ(0, pthreadpool_graph_add_dependency(graph, node, size_t(stages[stageId].dependencies[i] - stages)));
+		}
+	}
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (int iteration = 0; iteration < 100; iteration++) {
+		for (GraphStage& stage : stages) {
+			stage.processedItems = 0;
+		}
+		EXPECT_EQ(0, pthreadpool_graph_run(threadpool, graph));
+		for (size_t stageId = 0; stageId < 6; stageId++) {
+			EXPECT_EQ(stages[stageId].items, stages[stageId].processedItems) << "Stage " << stageId;
+			EXPECT_EQ(0, stages[stageId].earlyItems) << "Stage " << stageId;
+		}
+	}
+	pthreadpool_destroy(threadpool);
+	pthreadpool_graph_destroy(graph);
+}
+
+TEST(Graph, InvalidDependencyRejected) {
+	pthreadpool_graph_t graph = pthreadpool_graph_create();
+	EXPECT_TRUE(graph != nullptr);
+	size_t first, second;
+	EXPECT_EQ(0, pthreadpool_graph_add_1d(graph, computeNothing1D, nullptr, itemsCount1D, &first));
+	EXPECT_EQ(0, pthreadpool_graph_add_1d(graph, computeNothing1D, nullptr, itemsCount1D, &second));
+	EXPECT_EQ(EINVAL, pthreadpool_graph_add_dependency(graph, first, second));
+	EXPECT_EQ(EINVAL, pthreadpool_graph_add_dependency(graph, first, first));
+	EXPECT_EQ(EINVAL, pthreadpool_graph_add_dependency(graph, second + 1, first));
+	EXPECT_EQ(0, pthreadpool_graph_add_dependency(graph, second, first));
+	pthreadpool_graph_destroy(graph);
+}
+
+TEST(Graph, NullThreadPool) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool_graph_t graph = pthreadpool_graph_create();
+	EXPECT_TRUE(graph != nullptr);
+	size_t node;
+	EXPECT_EQ(0, pthreadpool_graph_add_1d(graph, reinterpret_cast<pthreadpool_function_1d_t>(increment1D),
+		processedCount, itemsCount1D, &node));
+	EXPECT_EQ(0, pthreadpool_graph_run(nullptr, graph));
+	pthreadpool_graph_destroy(graph);
+
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+struct NestedContext {
+	pthreadpool_t threadpool;
+	bool submit;
+	size_t innerItems;
+	size_t foreignThreadItems;
+};
+
+struct NestedInnerContext {
+	NestedContext* context;
+	pthread_t outerThread;
+};
+
+static void computeNestedInner(NestedInnerContext* innerContext, size_t) {
+	if (!pthread_equal(pthread_self(), innerContext->outerThread)) {
+		__atomic_add_fetch(&innerContext->context->foreignThreadItems, 1, __ATOMIC_RELAXED);
+	}
+	__atomic_add_fetch(&innerContext->context->innerItems, 1, __ATOMIC_RELAXED);
+}
+
+static void computeNestedOuter(NestedContext* context, size_t) {
+	NestedInnerContext innerContext = { context, pthread_self() };
+	if (context->submit) {
+		const pthreadpool_completion_t completion = pthreadpool_submit_1d(context->threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(computeNestedInner), &innerContext, itemsCount1D);
+		EXPECT_NE(0, pthreadpool_test(context->threadpool, completion));
+	} else {
+		pthreadpool_compute_1d(context->threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(computeNestedInner), &innerContext, itemsCount1D);
+	}
+}
+
+TEST(Nested, SameThreadPool) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (bool submit : { false, true }) {
+		NestedContext context = { threadpool, submit, 0, 0 };
+		pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(computeNestedOuter), &context, 64);
+		EXPECT_EQ(64 * itemsCount1D, context.innerItems);
+		EXPECT_EQ(0, context.foreignThreadItems);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Nested, OtherThreadPool) {
+	pthreadpool* outerThreadpool = pthreadpool_create(0);
+	EXPECT_TRUE(outerThreadpool != nullptr);
+	pthreadpool* innerThreadpool = pthreadpool_create(0);
+	EXPECT_TRUE(innerThreadpool != nullptr);
+	NestedContext context = { innerThreadpool, false, 0, 0 };
+	pthreadpool_compute_1d(outerThreadpool, reinterpret_cast<pthreadpool_function_1d_t>(computeNestedOuter), &context, 64);
+	EXPECT_EQ(64 * itemsCount1D, context.innerItems);
+	EXPECT_EQ(0, context.foreignThreadItems);
+	pthreadpool_destroy(innerThreadpool);
+	pthreadpool_destroy(outerThreadpool);
+}
+
+struct NestedCreateContext {
+	pthreadpool_t threadpool;
+	int error;
+};
+
+static void createNested1D(NestedCreateContext* context, size_t) {
+	context->threadpool = pthreadpool_create(2);
+	context->error = errno;
+}
+
+TEST(Nested, CreateThreadPool) {
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	NestedCreateContext context = { nullptr, 0 };
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(createNested1D), &context, 1);
+	EXPECT_TRUE(context.threadpool == nullptr);
+	EXPECT_EQ(EPERM, context.error);
+	pthreadpool_destroy(context.threadpool);
+	pthreadpool_destroy(threadpool);
+}
+
+static uint64_t getStatsItems(pthreadpool* threadpool, size_t threadsCount) {
+	std::vector<pthreadpool_thread_stats> stats(threadsCount + 1);
+	EXPECT_EQ(0, pthreadpool_get_stats(threadpool, stats.data(), stats.size()));
+	uint64_t items = 0;
+	for (const pthreadpool_thread_stats& threadStats : stats) {
+		items += threadStats.items;
+	}
+	EXPECT_EQ(0, stats[threadsCount].items);
+	return items;
+}
+
+TEST(Stats, ItemsCounted) {
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_thread_stats stats;
+	const int status = pthreadpool_get_stats(threadpool, &stats, 1);
+	if (status == ENOTSUP) {
+		/* The library is built without statistics */
+		pthreadpool_destroy(threadpool);
+		return;
+	}
+	EXPECT_EQ(0, status);
+	const uint64_t itemsBefore = getStatsItems(threadpool, 4);
+	pthreadpool_compute_1d(threadpool, computeNothing1D, NULL, itemsCount1D);
+	EXPECT_EQ(itemsBefore + itemsCount1D, getStatsItems(threadpool, 4));
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(Stats, NullThreadPool) {
+	pthreadpool_thread_stats stats;
+	const int status = pthreadpool_get_stats(nullptr, &stats, 1);
+	EXPECT_TRUE(status == EINVAL || status == ENOTSUP);
+}
+
+TEST(Trace, ChromeTraceFormat) {
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	size_t size = 0;
+	const int status = pthreadpool_get_trace(threadpool, nullptr, &size);
+	if (status == ENOTSUP) {
+		/* The library is built without tracing */
+		pthreadpool_destroy(threadpool);
+		return;
+	}
+	EXPECT_EQ(ENOSPC, status);
+	pthreadpool_compute_1d(threadpool, computeNothing1D, NULL, itemsCount1D);
+	EXPECT_EQ(ENOSPC, pthreadpool_get_trace(threadpool, nullptr, &size));
+	std::vector<char> trace(size);
+	EXPECT_EQ(0, pthreadpool_get_trace(threadpool, trace.data(), &size));
+	EXPECT_EQ(trace.size(), size);
+	const std::string json(trace.data());
+	EXPECT_EQ(size - 1, json.size());
+	EXPECT_EQ(0, json.find("{\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+	EXPECT_EQ(json.size() - 2, json.rfind("]}"));
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(SetThreadsCount, OutOfRangeRejected) {
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(EINVAL, pthreadpool_set_threads_count(threadpool, 0));
+	EXPECT_EQ(EINVAL, pthreadpool_set_threads_count(threadpool, 3));
+	EXPECT_EQ(2, pthreadpool_get_threads_count(threadpool));
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(SetThreadsCount, ShrinkAndGrow) {
+	int processedCount[itemsCount2DI * itemsCount2DJ];
+
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	const size_t threadsCounts[] = { 2, 1, 4, 3 };
+	for (size_t threadsCount : threadsCounts) {
+		EXPECT_EQ(0, pthreadpool_set_threads_count(threadpool, threadsCount));
+		EXPECT_EQ(threadsCount, pthreadpool_get_threads_count(threadpool));
+
+		/* Only the enabled threads may process items */
+		memset(processedCount, 0, sizeof(processedCount));
+		ScratchContext2DTiled context = { processedCount, threadsCount };
+		EXPECT_EQ(0, pthreadpool_compute_2d_tiled_with_scratch(threadpool,
+			reinterpret_cast<pthreadpool_function_2d_tiled_with_scratch_t>(incrementWithScratch2DTiled), &context,
+			itemsCount2DI, itemsCount2DJ, 1, 1, scratchSize2DTiled));
+		for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+/* Hibernation delay for the idle policy tests, and the idle time after which worker threads surely hibernate */
+const uint64_t hibernationDelayNs = UINT64_C(1000000);
+const useconds_t hibernationIdleUs = 20000;
+
+static void waitForAllThreads1D(size_t* arrivedThreads, size_t threadsCount) {
+	/* Every item blocks its thread until all threads process an item */
+	__atomic_add_fetch(arrivedThreads, 1, __ATOMIC_RELAXED);
+	while (__atomic_load_n(arrivedThreads, __ATOMIC_RELAXED) < threadsCount) {
+		sched_yield();
+	}
+}
+
+TEST(IdlePolicy, EachItemProcessedOnceAfterHibernation) {
+	int processedCount[itemsCount1D];
+	const size_t ranges[] = { 1, 2, 3, itemsCount1D };
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	pthreadpool_set_idle_policy(threadpool, 1, hibernationDelayNs);
+	for (size_t range : ranges) {
+		usleep(hibernationIdleUs);
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, range);
+		for (size_t itemId = 0; itemId < range; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times in a loop of " << range << " items";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(IdlePolicy, SubmittedFunctionWakesUpHibernatingThreads) {
+	int processedCount[itemsCount1D];
+
+	/* Without warm threads, and without the calling thread, only hibernating threads can process the function */
+	pthreadpool_attributes attributes = { 0 };
+	attributes.flags = PTHREADPOOL_FLAG_DEDICATED_WORKERS;
+	pthreadpool* threadpool = pthreadpool_create_with_attributes(&attributes);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	pthreadpool_set_idle_policy(threadpool, 0, hibernationDelayNs);
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	for (size_t range = 1; range <= 2; range++) {
+		usleep(hibernationIdleUs);
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_wait(threadpool, pthreadpool_submit_1d(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, range));
+		for (size_t itemId = 0; itemId < range; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+		}
+	}
+	usleep(hibernationIdleUs);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(IdlePolicy, LargeLoopWakesUpAllThreads) {
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	pthreadpool_set_idle_policy(threadpool, 1, hibernationDelayNs);
+	const size_t threadsCount = pthreadpool_get_threads_count(threadpool);
+	for (size_t iteration = 0; iteration < 3; iteration++) {
+		usleep(hibernationIdleUs);
+		size_t arrivedThreads = 0;
+		pthreadpool_compute_1d_tiled(threadpool,
+			[&](size_t, size_t) { waitForAllThreads1D(&arrivedThreads, threadsCount); }, threadsCount, 1);
+		EXPECT_EQ(threadsCount, arrivedThreads);
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(IdlePolicy, ShrinkAndGrowWithHibernatingThreads) {
+	int processedCount[itemsCount1D];
+
+	pthreadpool* threadpool = pthreadpool_create(4);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_set_spin_wait_iterations(threadpool, 0);
+	pthreadpool_set_idle_policy(threadpool, 0, hibernationDelayNs);
+	const size_t threadsCounts[] = { 2, 4, 1, 3 };
+	for (size_t threadsCount : threadsCounts) {
+		usleep(hibernationIdleUs);
+		EXPECT_EQ(0, pthreadpool_set_threads_count(threadpool, threadsCount));
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_wait(threadpool, pthreadpool_submit_1d(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D));
+		for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static pthreadpool* createLazyThreadPool(size_t threadsCount, uint32_t flags) {
+	pthreadpool_attributes attributes = { 0 };
+	attributes.threads_count = threadsCount;
+	attributes.flags = PTHREADPOOL_FLAG_LAZY_WORKERS | flags;
+	return pthreadpool_create_with_attributes(&attributes);
+}
+
+TEST(LazyWorkers, DestroyWithoutJobs) {
+	pthreadpool* threadpool = createLazyThreadPool(4, 0);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(4, pthreadpool_get_threads_count(threadpool));
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(LazyWorkers, EachItemProcessedOnce) {
+	int processedCount[itemsCount1D];
+	const size_t ranges[] = { 1, 2, 3, itemsCount1D };
+
+	pthreadpool* threadpool = createLazyThreadPool(0, 0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t range : ranges) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, range);
+		for (size_t itemId = 0; itemId < range; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] <<
+				" times in a loop of " << range << " items";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(LazyWorkers, SingleItemRunsOnCaller) {
+	pthreadpool* threadpool = createLazyThreadPool(4, 0);
+	EXPECT_TRUE(threadpool != nullptr);
+	ThreadsContext context = { PTHREAD_MUTEX_INITIALIZER };
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(recordThread1D), &context, 1);
+	EXPECT_EQ(1, context.threads.size());
+	EXPECT_EQ(1, context.threads.count(pthread_self()));
+
+	/* A loop which can keep all threads busy starts them all */
+	size_t arrivedThreads = 0;
+	pthreadpool_compute_1d_tiled(threadpool, [&](size_t, size_t) { waitForAllThreads1D(&arrivedThreads, 4); }, 4, 1);
+	EXPECT_EQ(4, arrivedThreads);
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(LazyWorkers, DedicatedWorkersProcessSubmittedFunctions) {
+	int processedCount[itemsCount1D];
+
+	pthreadpool* threadpool = createLazyThreadPool(4, PTHREADPOOL_FLAG_DEDICATED_WORKERS);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (size_t range = 1; range <= 3; range++) {
+		memset(processedCount, 0, sizeof(processedCount));
+		pthreadpool_wait(threadpool, pthreadpool_submit_1d(threadpool,
+			reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, range));
+		for (size_t itemId = 0; itemId < range; itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+static void getDefaultNested1D(pthreadpool_t* threadpool, size_t) {
+	*threadpool = pthreadpool_get_default();
+}
+
+TEST(DefaultThreadPool, NullInNestedCall) {
+	pthreadpool* threadpool = pthreadpool_create(2);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_t nestedThreadpool = threadpool;
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(getDefaultNested1D), &nestedThreadpool, 1);
+	EXPECT_TRUE(nestedThreadpool == nullptr);
+	pthreadpool_destroy(threadpool);
+
+	/* The nested call doesn't create the default thread pool */
+	pthreadpool* defaultThreadpool = pthreadpool_get_default();
+	EXPECT_TRUE(defaultThreadpool != nullptr);
+	EXPECT_LE(1, pthreadpool_get_threads_count(defaultThreadpool));
+}
+
+TEST(DefaultThreadPool, SameThreadPool) {
+	pthreadpool* threadpool = pthreadpool_get_default();
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_EQ(threadpool, pthreadpool_get_default());
+}
+
+TEST(DefaultThreadPool, DestroyIgnored) {
+	int processedCount[itemsCount1D];
+	memset(processedCount, 0, sizeof(processedCount));
+
+	pthreadpool* threadpool = pthreadpool_get_default();
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_destroy(threadpool);
+	EXPECT_EQ(threadpool, pthreadpool_get_default());
+	pthreadpool_compute_1d(threadpool, reinterpret_cast<pthreadpool_function_1d_t>(increment1D), processedCount, itemsCount1D);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+}
+
+TEST(CxxCompute1D, EachItemProcessedOnce) {
+	std::vector<int> processedCount(itemsCount1D);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d(threadpool, [&](size_t i) { processedCount[i] += 1; }, itemsCount1D);
+	for (size_t itemId = 0; itemId < itemsCount1D; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CxxCompute1DTiled, EachItemProcessedOnce) {
+	std::vector<int> processedCount(itemsCount1DTiled);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_1d_tiled_with_flags(threadpool,
+		[&](size_t start, size_t tile) {
+			EXPECT_LE(tile, tileSize1DTiled);
+			for (size_t i = start; i < start + tile; i++) {
+				processedCount[i] += 1;
+			}
+		}, itemsCount1DTiled, tileSize1DTiled, PTHREADPOOL_FLAG_SCHEDULE_GUIDED);
+	for (size_t itemId = 0; itemId < itemsCount1DTiled; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CxxCompute1DCancellable, StopsAfterCancellingItem) {
+	size_t processedItems = 0;
+	EXPECT_TRUE(pthreadpool_compute_1d_cancellable(nullptr,
+		[&](size_t i) {
+			processedItems += 1;
+			return i == cancellingItem;
+		}, itemsCount1D));
+	EXPECT_EQ(cancellingItem + 1, processedItems);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	EXPECT_FALSE(pthreadpool_compute_1d_cancellable(threadpool, [](size_t) { return false; }, itemsCount1D));
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CxxCompute2D, EachItemProcessedOnce) {
+	/* Grids with longer and shorter rows than the number of items per tile */
+	const size_t ranges[][2] = { { itemsCount2DI, itemsCount2DJ }, { 3, 10000 }, { 10000, 3 }, { 0, 5 }, { 5, 0 } };
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	for (const size_t* range : ranges) {
+		std::vector<int> processedCount(range[0] * range[1]);
+		const size_t rangeJ = range[1];
+		pthreadpool_compute_2d(threadpool, [&](size_t i, size_t j) { processedCount[i * rangeJ + j] += 1; }, range[0], range[1]);
+		for (size_t itemId = 0; itemId < processedCount.size(); itemId++) {
+			EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+		}
+	}
+	pthreadpool_destroy(threadpool);
+}
+
+TEST(CxxCompute2DTiled, EachItemProcessedOnce) {
+	std::vector<int> processedCount(itemsCount2DI * itemsCount2DJ);
+
+	pthreadpool* threadpool = pthreadpool_create(0);
+	EXPECT_TRUE(threadpool != nullptr);
+	pthreadpool_compute_2d_tiled(threadpool,
+		[&](size_t startI, size_t startJ, size_t tileI, size_t tileJ) {
+			increment2DTiled(processedCount.data(), startI, startJ, tileI, tileJ);
+		}, itemsCount2DI, itemsCount2DJ, tileSize2DI, tileSize2DJ);
+	for (size_t itemId = 0; itemId < itemsCount2DI * itemsCount2DJ; itemId++) {
+		EXPECT_EQ(1, processedCount[itemId]) << "Item " << itemId << " processed " << processedCount[itemId] << " times";
+	}
+	pthreadpool_destroy(threadpool);
+}
+
 int main(int argc, char* argv[]) {
 	setenv("TERM", "xterm-256color", 0);
 	::testing::InitGoogleTest(&argc, argv);